@@ -0,0 +1,79 @@
+# Generates a C++ source that compiles every file under ASSET_DIR into the
+# executable as read-only data, plus the table AssetIndex::embedded() reads.
+#
+#   cmake -DASSET_DIR=<dir> -DOUTPUT=<file.cpp> -DWORK_DIR=<dir> -P EmbedAssets.cmake
+#
+# Text-like files (html, js, wasm, ...) also get a gzip variant, kept only
+# when it is smaller, which is served to clients that accept it.
+
+cmake_minimum_required(VERSION 3.20)
+
+if(NOT ASSET_DIR OR NOT OUTPUT OR NOT WORK_DIR)
+  message(FATAL_ERROR "EmbedAssets.cmake needs ASSET_DIR, OUTPUT and WORK_DIR")
+endif()
+
+get_filename_component(ASSET_DIR "${ASSET_DIR}" ABSOLUTE)
+
+set(COMPRESSIBLE html js mjs wasm css json map svg txt)
+
+# Append the bytes of FILE to CONTENT as a `const unsigned char NAME[]`.
+# A trailing zero keeps empty files valid C++; sizes are stored separately.
+function(embed_array NAME FILE CONTENT_VAR)
+  file(READ "${FILE}" hex HEX)
+  string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," hex "${hex}")
+  string(REGEX REPLACE "((0x[0-9a-f][0-9a-f],){32})" "\\1\n  " hex "${hex}")
+  set(${CONTENT_VAR} "${${CONTENT_VAR}}const unsigned char ${NAME}[] = {\n  ${hex}0x00\n};\n\n" PARENT_SCOPE)
+endfunction()
+
+file(GLOB_RECURSE files LIST_DIRECTORIES false RELATIVE "${ASSET_DIR}" "${ASSET_DIR}/*")
+list(SORT files)
+file(MAKE_DIRECTORY "${WORK_DIR}")
+
+set(arrays "")
+set(entries "")
+set(index 0)
+foreach(path IN LISTS files)
+  # Precompressed files next to their originals are regenerated here
+  if(path MATCHES "\\.gz$")
+    continue()
+  endif()
+
+  set(source "${ASSET_DIR}/${path}")
+  file(SIZE "${source}" size)
+  embed_array("kAsset${index}" "${source}" arrays)
+
+  set(gzipName "nullptr")
+  set(gzipSize 0)
+  get_filename_component(extension "${path}" LAST_EXT)
+  string(TOLOWER "${extension}" extension)
+  string(REGEX REPLACE "^\\." "" extension "${extension}")
+  if(extension IN_LIST COMPRESSIBLE AND size GREATER 0)
+    set(compressed "${WORK_DIR}/asset${index}.gz")
+    file(ARCHIVE_CREATE OUTPUT "${compressed}" PATHS "${source}"
+         FORMAT raw COMPRESSION GZip COMPRESSION_LEVEL 9)
+    file(SIZE "${compressed}" compressedSize)
+    if(compressedSize LESS size)
+      embed_array("kAsset${index}Gzip" "${compressed}" arrays)
+      set(gzipName "kAsset${index}Gzip")
+      set(gzipSize ${compressedSize})
+    endif()
+  endif()
+
+  string(APPEND entries "  {\"${path}\", kAsset${index}, ${size}, ${gzipName}, ${gzipSize}},\n")
+  math(EXPR index "${index} + 1")
+endforeach()
+
+if(index EQUAL 0)
+  message(FATAL_ERROR "No assets found in ${ASSET_DIR}; build the client first (cd src/client && ./build.sh)")
+endif()
+
+set(content "// Generated by cmake/EmbedAssets.cmake from ${ASSET_DIR}. Do not edit.\n\n")
+string(APPEND content "#include \"asset/EmbeddedAssets.hpp\"\n\n")
+string(APPEND content "namespace {\n\n${arrays}}\n\n")
+string(APPEND content "const EmbeddedAsset kEmbeddedAssets[] = {\n${entries}};\n\n")
+string(APPEND content "const size_t kEmbeddedAssetCount = ${index};\n")
+
+# Only touch the output when it changed, so unrelated rebuilds stay incremental
+file(WRITE "${OUTPUT}.tmp" "${content}")
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different "${OUTPUT}.tmp" "${OUTPUT}")
+file(REMOVE "${OUTPUT}.tmp")
@@ -7,6 +7,14 @@
 #include "oatpp/parser/json/mapping/ObjectMapper.hpp"
 #include "oatpp/core/macro/component.hpp"
 
+#include "cache/ResponseCache.hpp"
+
+#ifdef METAL_SERVER_UI
+#include "ui/CounterSession.hpp"
+#include "ui/UiSocket.hpp"
+#include "oatpp/core/async/Executor.hpp"
+#endif
+
 /**
  * Application Components Configuration
  */
@@ -42,14 +50,49 @@ public:
   }());
   
   /**
-   * Create ObjectMapper component for JSON serialization/deserialization
+   * Create ObjectMapper component for JSON serialization/deserialization.
+   * Pretty-printed in debug builds only; JSON_PRETTY=1 or 0 overrides.
    */
   OATPP_CREATE_COMPONENT(std::shared_ptr<oatpp::data::mapping::ObjectMapper>, apiObjectMapper)([] {
     auto mapper = oatpp::parser::json::mapping::ObjectMapper::createShared();
-    mapper->getSerializer()->getConfig()->useBeautifier = true;
+#ifdef NDEBUG
+    bool pretty = false;
+#else
+    bool pretty = true;
+#endif
+    const char* prettyEnv = std::getenv("JSON_PRETTY");
+    if (prettyEnv) {
+      pretty = std::string(prettyEnv) != "0";
+    }
+    mapper->getSerializer()->getConfig()->useBeautifier = pretty;
     return mapper;
   }());
 
+  /**
+   * Create ResponseCache component shared by the API endpoints that opt in.
+   * Holds RESPONSE_CACHE_SIZE responses (default 4096).
+   */
+  OATPP_CREATE_COMPONENT(std::shared_ptr<ResponseCache>, responseCache)([] {
+    const char* sizeEnv = std::getenv("RESPONSE_CACHE_SIZE");
+    size_t capacity = sizeEnv ? static_cast<size_t>(std::strtoul(sizeEnv, nullptr, 10)) : 4096;
+    return std::make_shared<ResponseCache>(capacity);
+  }());
+
+#ifdef METAL_SERVER_UI
+  /**
+   * Create ConnectionHandler for server-driven view sockets (/ui). Sockets
+   * are coroutines on the executor's few threads, not a thread each.
+   */
+  OATPP_CREATE_COMPONENT(std::shared_ptr<oatpp::network::ConnectionHandler>, websocketConnectionHandler)("websocket", [] {
+    auto executor = std::make_shared<oatpp::async::Executor>();
+    auto handler = oatpp::websocket::AsyncConnectionHandler::createShared(executor);
+    handler->setSocketInstanceListener(std::make_shared<UiSocketInstanceListener>([] {
+      return std::make_unique<CounterSession>();
+    }));
+    return handler;
+  }());
+#endif
+
 };
 
 #endif /* AppComponent_hpp */
@@ -0,0 +1,273 @@
+#ifndef AssetIndex_hpp
+#define AssetIndex_hpp
+
+#include "oatpp/core/Types.hpp"
+#include "oatpp/core/base/Environment.hpp"
+
+#ifdef METAL_EMBED_ASSETS
+#include "asset/EmbeddedAssets.hpp"
+#endif
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * A static file ready to be served: body and response headers are built once
+ * when the index is created, so serving it allocates nothing per request.
+ *
+ * A file read from disk has its bytes in `body`. A file compiled into the
+ * executable keeps them where they are: `data` points into kEmbeddedAssets
+ * and `body` stays nullptr (see EmbeddedBody).
+ */
+struct Asset {
+  std::string path;            // Relative URL path, e.g. "client.wasm"
+  oatpp::String body;
+  const unsigned char* data = nullptr;
+  size_t size = 0;
+  oatpp::String contentType;
+  oatpp::String etag;          // Strong validator: quoted hash of the body
+  oatpp::String gzipBody;      // Precompressed variant, or nullptr
+  const unsigned char* gzipData = nullptr;
+  size_t gzipSize = 0;
+  oatpp::String gzipEtag;      // Each encoding is its own representation
+  std::vector<std::pair<oatpp::String, oatpp::String>> headers;  // Sent with every response
+
+  bool isEmbedded() const {
+    return data != nullptr;
+  }
+
+  bool hasGzip() const {
+    return gzipBody || gzipData;
+  }
+
+  /**
+   * The uncompressed content as a string; a copy for embedded files, so for
+   * startup use (e.g. reading the manifest), not per request
+   */
+  oatpp::String text() const {
+    return isEmbedded() ? oatpp::String(std::string(reinterpret_cast<const char*>(data), size)) : body;
+  }
+};
+
+/**
+ * Asset Index - Every servable static file, keyed by URL path
+ *
+ * Built once at startup (scan() walks the static tree, nested directories
+ * included). Requests resolve with one hash lookup on the exact path, so a
+ * path that is not in the index - "../etc/passwd" included - can never reach
+ * the filesystem. Symlinks are skipped while scanning for the same reason.
+ *
+ * A directory's index.html is also reachable as "dir/" (and the root one as
+ * the empty path). A "name.gz" next to "name" becomes its gzip variant.
+ */
+class AssetIndex {
+public:
+
+  /**
+   * Index every regular file under `root`
+   */
+  static std::shared_ptr<AssetIndex> scan(const std::string& root) {
+    std::map<std::string, oatpp::String> files;
+    std::error_code error;
+    std::filesystem::recursive_directory_iterator it(root, error), end;
+    for (; !error && it != end; it.increment(error)) {
+      const auto& entry = *it;
+      if (entry.is_symlink() || !entry.is_regular_file()) {
+        continue;
+      }
+      oatpp::String body = readFile(entry.path());
+      if (body) {
+        files[entry.path().lexically_relative(root).generic_string()] = body;
+      }
+    }
+    if (error) {
+      OATPP_LOGD("AssetIndex", "Stopped scanning %s: %s", root.c_str(), error.message().c_str());
+    }
+
+    auto index = std::make_shared<AssetIndex>();
+    for (const auto& file : files) {
+      const std::string& path = file.first;
+      bool isVariant = path.size() > 3 && path.compare(path.size() - 3, 3, ".gz") == 0 &&
+                       files.count(path.substr(0, path.size() - 3)) > 0;
+      if (!isVariant) {
+        auto gzip = files.find(path + ".gz");
+        index->add(path, file.second, gzip != files.end() ? gzip->second : nullptr);
+      }
+    }
+    OATPP_LOGI("AssetIndex", "Indexed %d files from %s", (int) files.size(), root.c_str());
+    return index;
+  }
+
+#ifdef METAL_EMBED_ASSETS
+  /**
+   * Index the files compiled into the executable. Nothing is copied: assets
+   * point into the read-only data and are served from there.
+   */
+  static std::shared_ptr<AssetIndex> embedded() {
+    auto index = std::make_shared<AssetIndex>();
+    for (size_t i = 0; i < kEmbeddedAssetCount; ++i) {
+      const EmbeddedAsset& file = kEmbeddedAssets[i];
+      auto asset = std::make_shared<Asset>();
+      asset->path = file.path;
+      asset->data = file.data;
+      asset->size = file.size;
+      asset->gzipData = file.gzipData;
+      asset->gzipSize = file.gzipData ? file.gzipSize : 0;
+      index->insert(asset);
+    }
+    OATPP_LOGI("AssetIndex", "Indexed %d embedded files", (int) kEmbeddedAssetCount);
+    return index;
+  }
+#endif
+
+  /**
+   * Add (or replace) the asset served at `path`, with an optional gzip variant
+   */
+  void add(const std::string& path, const oatpp::String& body, const oatpp::String& gzipBody = nullptr) {
+    auto asset = std::make_shared<Asset>();
+    asset->path = path;
+    asset->body = body;
+    asset->gzipBody = gzipBody;
+    insert(asset);
+  }
+
+  /**
+   * Look up a request path (with or without the leading '/'; a query string
+   * is ignored). Returns nullptr when nothing is served there.
+   */
+  std::shared_ptr<const Asset> find(const std::string& requestPath) const {
+    size_t begin = !requestPath.empty() && requestPath[0] == '/' ? 1 : 0;
+    size_t end = requestPath.find_first_of("?#", begin);
+    auto it = m_assets.find(requestPath.substr(begin, end == std::string::npos ? end : end - begin));
+    return it != m_assets.end() ? it->second : nullptr;
+  }
+
+  /**
+   * Number of index entries (directory aliases included)
+   */
+  size_t size() const {
+    return m_assets.size();
+  }
+
+  /**
+   * Visit every entry, aliases included, as f(path, asset)
+   */
+  template <typename F>
+  void forEach(F&& f) const {
+    for (const auto& entry : m_assets) {
+      f(entry.first, *entry.second);
+    }
+  }
+
+  /**
+   * Content type from the file extension (the suffix after the last '.')
+   */
+  static oatpp::String contentTypeFor(const std::string& path) {
+    static const std::unordered_map<std::string, oatpp::String> types = {
+      {"html", "text/html; charset=utf-8"},
+      {"js", "application/javascript"},
+      {"mjs", "application/javascript"},
+      {"wasm", "application/wasm"},
+      {"css", "text/css"},
+      {"json", "application/json"},
+      {"map", "application/json"},
+      {"txt", "text/plain; charset=utf-8"},
+      {"png", "image/png"},
+      {"jpg", "image/jpeg"},
+      {"jpeg", "image/jpeg"},
+      {"gif", "image/gif"},
+      {"svg", "image/svg+xml"},
+      {"ico", "image/x-icon"},
+      {"webp", "image/webp"},
+      {"woff", "font/woff"},
+      {"woff2", "font/woff2"}
+    };
+    size_t slash = path.rfind('/');
+    size_t dot = path.rfind('.');
+    if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) {
+      std::string extension = path.substr(dot + 1);
+      for (char& c : extension) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+      }
+      auto it = types.find(extension);
+      if (it != types.end()) {
+        return it->second;
+      }
+    }
+    return "application/octet-stream";
+  }
+
+private:
+
+  // Headers and validators for a new asset, then its path (and a directory
+  // alias for an index.html) in the index
+  void insert(const std::shared_ptr<Asset>& asset) {
+    const unsigned char* content = asset->isEmbedded()
+        ? asset->data : reinterpret_cast<const unsigned char*>(asset->body->data());
+    size_t size = asset->isEmbedded() ? asset->size : asset->body->size();
+    asset->contentType = contentTypeFor(asset->path);
+    asset->etag = makeEtag(content, size, "");
+    asset->headers = {
+      {"Content-Type", asset->contentType},
+      // Names are not content-hashed, so always revalidate (a 304 is cheap)
+      {"Cache-Control", "no-cache"},
+      // Cross-origin isolation for SharedArrayBuffer (threaded framework build)
+      {"Cross-Origin-Opener-Policy", "same-origin"},
+      {"Cross-Origin-Embedder-Policy", "require-corp"}
+    };
+    if (asset->hasGzip()) {
+      asset->gzipEtag = makeEtag(content, size, "-gzip");
+      asset->headers.push_back({"Vary", "Accept-Encoding"});
+    }
+
+    const std::string& path = asset->path;
+    m_assets[path] = asset;
+    const std::string indexName = "index.html";
+    if (path == indexName) {
+      m_assets[""] = asset;
+    } else if (path.size() > indexName.size() &&
+               path.compare(path.size() - indexName.size() - 1, std::string::npos, "/" + indexName) == 0) {
+      m_assets[path.substr(0, path.size() - indexName.size())] = asset;
+    }
+  }
+
+  static oatpp::String readFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+      OATPP_LOGD("AssetIndex", "Failed to open file: %s", path.string().c_str());
+      return nullptr;
+    }
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    std::string buffer(static_cast<size_t>(size), '\0');
+    if (!file.read(&buffer[0], size)) {
+      OATPP_LOGD("AssetIndex", "Failed to read file: %s", path.string().c_str());
+      return nullptr;
+    }
+    return oatpp::String(std::move(buffer));
+  }
+
+  // 64-bit FNV-1a of the content, quoted as an entity tag
+  static oatpp::String makeEtag(const unsigned char* content, size_t size, const char* suffix) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+      hash = (hash ^ content[i]) * 1099511628211ull;
+    }
+    char buffer[40];
+    std::snprintf(buffer, sizeof(buffer), "\"%016llx%s\"", static_cast<unsigned long long>(hash), suffix);
+    return buffer;
+  }
+
+  std::unordered_map<std::string, std::shared_ptr<const Asset>> m_assets;
+};
+
+#endif /* AssetIndex_hpp */
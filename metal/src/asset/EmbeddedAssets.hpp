@@ -0,0 +1,21 @@
+#ifndef EmbeddedAssets_hpp
+#define EmbeddedAssets_hpp
+
+#include <cstddef>
+
+/**
+ * A file compiled into the executable (CMake option METAL_EMBED_ASSETS).
+ * The table is generated by cmake/EmbedAssets.cmake.
+ */
+struct EmbeddedAsset {
+  const char* path;                 // Relative URL path, e.g. "client.wasm"
+  const unsigned char* data;
+  size_t size;
+  const unsigned char* gzipData;    // Precompressed variant, or nullptr
+  size_t gzipSize;
+};
+
+extern const EmbeddedAsset kEmbeddedAssets[];
+extern const size_t kEmbeddedAssetCount;
+
+#endif /* EmbeddedAssets_hpp */
@@ -0,0 +1,54 @@
+#ifndef EmbeddedBody_hpp
+#define EmbeddedBody_hpp
+
+#include "oatpp/web/protocol/http/outgoing/Body.hpp"
+
+#include <cstddef>
+#include <cstring>
+
+/**
+ * Embedded Body - A response body read straight from bytes that outlive it
+ *
+ * For files compiled into the executable (see AssetIndex::embedded): the
+ * bytes stay in the read-only data and every response points at them, so
+ * nothing is copied at startup or per request. One is made per response;
+ * it only holds the pointer and how far the response has been written.
+ */
+class EmbeddedBody : public oatpp::web::protocol::http::outgoing::Body {
+private:
+  const unsigned char* m_data;
+  size_t m_size;
+  size_t m_offset = 0;
+
+public:
+
+  EmbeddedBody(const unsigned char* data, size_t size)
+    : m_data(data)
+    , m_size(size)
+  {}
+
+  oatpp::v_io_size read(void* buffer, v_buff_size count, oatpp::async::Action& /* action */) override {
+    size_t left = m_size - m_offset;
+    if (count <= 0 || left == 0) {
+      return 0;
+    }
+    size_t chunk = static_cast<size_t>(count) < left ? static_cast<size_t>(count) : left;
+    std::memcpy(buffer, m_data + m_offset, chunk);
+    m_offset += chunk;
+    return static_cast<oatpp::v_io_size>(chunk);
+  }
+
+  // Content-Type and the rest come from the asset's own headers
+  void declareHeaders(Headers& /* headers */) override {}
+
+  p_char8 getKnownData() override {
+    return const_cast<p_char8>(m_data);
+  }
+
+  v_int64 getKnownSize() override {
+    return static_cast<v_int64>(m_size);
+  }
+
+};
+
+#endif /* EmbeddedBody_hpp */
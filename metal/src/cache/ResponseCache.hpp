@@ -0,0 +1,236 @@
+#ifndef ResponseCache_hpp
+#define ResponseCache_hpp
+
+#include "oatpp/web/protocol/http/Http.hpp"
+#include "oatpp/core/Types.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Response Cache - Sharded, bounded LRU of rendered responses
+ *
+ * Endpoints opt in one by one (see ApiController::cached) with a key built
+ * from what the response depends on - the endpoint and its query values -
+ * and a TTL. Keys hash to one of a fixed number of shards, each with its own
+ * lock, LRU list and share of the capacity, so concurrent requests for
+ * different keys rarely contend.
+ *
+ * Misses are single-flight: while one request renders a key, concurrent
+ * requests for the same key wait for that result instead of rendering it
+ * again. Only 2xx responses are stored; a failure is still handed to the
+ * requests that waited on it, then forgotten.
+ */
+class ResponseCache {
+public:
+
+  /**
+   * What is stored: enough to rebuild the response without rendering it
+   */
+  struct Entry {
+    oatpp::web::protocol::http::Status status;
+    oatpp::String body;
+    oatpp::String contentType;
+  };
+
+  /**
+   * How a lookup was answered
+   */
+  enum class Outcome {
+    HIT,        // From the cache
+    MISS,       // Rendered by this request
+    COALESCED   // Rendered by a concurrent request for the same key
+  };
+
+  /**
+   * Counters, summed over all shards
+   */
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t coalesced = 0;
+    uint64_t evictions = 0;   // Dropped to stay within capacity
+    uint64_t expirations = 0; // Found past their TTL
+    uint64_t entries = 0;
+    uint64_t capacity = 0;
+  };
+
+private:
+
+  using Clock = std::chrono::steady_clock;
+
+  struct Node {
+    std::string key;
+    std::shared_ptr<const Entry> entry;
+    Clock::time_point expires;
+  };
+
+  // One render in progress, and the requests waiting for it
+  struct Flight {
+    std::mutex mutex;
+    std::condition_variable finished;
+    bool done = false;
+    std::shared_ptr<const Entry> entry;
+    std::exception_ptr error;
+  };
+
+  struct Shard {
+    std::mutex mutex;
+    std::list<Node> lru;  // Most recently used first
+    std::unordered_map<std::string, std::list<Node>::iterator> index;
+    std::unordered_map<std::string, std::shared_ptr<Flight>> flights;
+    size_t capacity = 0;
+    Stats stats;
+  };
+
+  std::vector<std::unique_ptr<Shard>> m_shards;
+
+  Shard& shardFor(const std::string& key) const {
+    return *m_shards[std::hash<std::string>()(key) % m_shards.size()];
+  }
+
+  static bool isStorable(const Entry& entry) {
+    return entry.status.code >= 200 && entry.status.code < 300;
+  }
+
+  // Called with the shard locked
+  static void insert(Shard& shard, const std::string& key, std::shared_ptr<const Entry> entry,
+                     Clock::time_point expires) {
+    auto existing = shard.index.find(key);
+    if (existing != shard.index.end()) {
+      shard.lru.erase(existing->second);
+      shard.index.erase(existing);
+    }
+    shard.lru.push_front(Node{key, std::move(entry), expires});
+    shard.index.emplace(key, shard.lru.begin());
+    while (shard.lru.size() > shard.capacity) {
+      shard.index.erase(shard.lru.back().key);
+      shard.lru.pop_back();
+      shard.stats.evictions++;
+    }
+  }
+
+public:
+
+  /**
+   * Hold at most `capacity` responses, spread over `shardCount` shards
+   */
+  explicit ResponseCache(size_t capacity, size_t shardCount = 16) {
+    shardCount = shardCount > 0 ? shardCount : 1;
+    for (size_t i = 0; i < shardCount; ++i) {
+      auto shard = std::make_unique<Shard>();
+      // Spread the remainder so the shard capacities add up to `capacity`
+      shard->capacity = capacity / shardCount + (i < capacity % shardCount ? 1 : 0);
+      m_shards.push_back(std::move(shard));
+    }
+  }
+
+  /**
+   * The response stored under `key`, or the result of `render()` - which
+   * then stays cached for `ttl`. Exceptions from `render` propagate to this
+   * request and to every request coalesced onto it.
+   */
+  template <typename F>
+  std::shared_ptr<const Entry> getOrRender(const std::string& key, std::chrono::milliseconds ttl,
+                                           F&& render, Outcome* outcome = nullptr) {
+    Shard& shard = shardFor(key);
+    std::shared_ptr<Flight> flight;
+    bool leader = false;
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto it = shard.index.find(key);
+      if (it != shard.index.end()) {
+        if (Clock::now() < it->second->expires) {
+          shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+          shard.stats.hits++;
+          if (outcome) *outcome = Outcome::HIT;
+          return it->second->entry;
+        }
+        shard.lru.erase(it->second);
+        shard.index.erase(it);
+        shard.stats.expirations++;
+      }
+
+      auto inFlight = shard.flights.find(key);
+      if (inFlight != shard.flights.end()) {
+        flight = inFlight->second;
+        shard.stats.coalesced++;
+      } else {
+        flight = std::make_shared<Flight>();
+        shard.flights.emplace(key, flight);
+        shard.stats.misses++;
+        leader = true;
+      }
+    }
+
+    if (!leader) {
+      std::unique_lock<std::mutex> lock(flight->mutex);
+      flight->finished.wait(lock, [&flight]() { return flight->done; });
+      if (flight->error) {
+        std::rethrow_exception(flight->error);
+      }
+      if (outcome) *outcome = Outcome::COALESCED;
+      return flight->entry;
+    }
+
+    std::shared_ptr<const Entry> entry;
+    std::exception_ptr error;
+    try {
+      entry = std::make_shared<const Entry>(render());
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.flights.erase(key);
+      if (entry && ttl.count() > 0 && isStorable(*entry)) {
+        insert(shard, key, entry, Clock::now() + ttl);
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock(flight->mutex);
+      flight->entry = entry;
+      flight->error = error;
+      flight->done = true;
+    }
+    flight->finished.notify_all();
+
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    if (outcome) *outcome = Outcome::MISS;
+    return entry;
+  }
+
+  /**
+   * Current counters (each shard is read under its own lock)
+   */
+  Stats stats() const {
+    Stats total;
+    for (const auto& shard : m_shards) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      total.hits += shard->stats.hits;
+      total.misses += shard->stats.misses;
+      total.coalesced += shard->stats.coalesced;
+      total.evictions += shard->stats.evictions;
+      total.expirations += shard->stats.expirations;
+      total.entries += shard->lru.size();
+      total.capacity += shard->capacity;
+    }
+    return total;
+  }
+
+};
+
+#endif /* ResponseCache_hpp */
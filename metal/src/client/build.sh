@@ -39,9 +39,27 @@ emcc client.cpp \
     -s EXPORTED_RUNTIME_METHODS='["ccall","cwrap"]' \
     --bind
 
-# Copy HTML file to output
-echo "📄 Copying index.html to output..."
-cp index.html output/
+# Copy HTML file to output, stamped with the module's content hash (the
+# loader's cache key), and the loader shared with the framework
+echo "📄 Copying index.html, wasm-loader.js and asset-manifest.json to output..."
+if command -v sha256sum &> /dev/null; then
+    WASM_HASH=$(sha256sum output/client.wasm | cut -c1-16)
+else
+    WASM_HASH=$(shasum -a 256 output/client.wasm | cut -c1-16)
+fi
+sed "s/__WASM_HASH__/$WASM_HASH/" index.html > output/index.html
+
+# Build manifest: what the server preloads (Link headers) with the document.
+# The wasm URL matches the one wasm-loader.js fetches, hash included.
+cat > output/asset-manifest.json <<EOF
+{
+  "preload": [
+    {"href": "/client.js", "as": "script"},
+    {"href": "/client.wasm?v=$WASM_HASH", "as": "fetch", "type": "application/wasm"}
+  ]
+}
+EOF
+cp ../framework/wasm-loader.js output/
 
 echo ""
 echo "✅ Build completed successfully!"
@@ -50,6 +68,8 @@ echo "📁 Output files:"
 echo "   - output/client.js (JavaScript glue code)"
 echo "   - output/client.wasm (WebAssembly binary)"
 echo "   - output/index.html (HTML interface)"
+echo "   - output/wasm-loader.js (streaming loader with module cache)"
+echo "   - output/asset-manifest.json (assets the server preloads)"
 echo ""
 echo "🚀 To run the client:"
 echo "   cd output"
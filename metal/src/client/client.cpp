@@ -3,26 +3,185 @@
 // These can be safely ignored - the code compiles correctly with emcc.
 // Build with: ./build.sh
 
+#include <emscripten.h>
 #include <emscripten/bind.h>
+#include <emscripten/html5.h>
 #include <emscripten/val.h>
 #include <string>
 #include <iostream>
 #include <ctime>
+#include <unordered_map>
+#include <vector>
+#include "../rpc/RpcProtocol.hpp"
 
 using namespace emscripten;
 
+// A call waiting for its result: the JS callback, and how to turn the
+// result bytes into the value it receives
+struct RpcCall {
+    val callback;
+    val (*decode)(RpcReader& result);
+};
+
+// Batches sent to the server, by batch ID, until their response arrives
+std::unordered_map<int, std::vector<RpcCall>> g_rpcInFlight;
+int g_nextRpcBatch = 0;
+
+// POST one batch to /api/rpc. The response bytes, or an error message,
+// come back through onRpcResponse.
+EM_JS(void, js_postRpcBatch, (const char* url, const char* data, int size, int batch), {
+    fetch(UTF8ToString(url), {
+        method: "POST",
+        headers: { "Content-Type": "application/octet-stream" },
+        body: HEAPU8.slice(data, data + size)
+    })
+        .then((response) => response.ok
+            ? response.arrayBuffer()
+            : Promise.reject(new Error("HTTP " + response.status)))
+        .then((buffer) => Module.onRpcResponse(batch, new Uint8Array(buffer), ""))
+        .catch((error) => Module.onRpcResponse(batch, new Uint8Array(0), String(error.message || error)));
+});
+
+// Decoders for typed results
+val decodeString(RpcReader& result) {
+    return val(result.readString());
+}
+
+val decodeI64(RpcReader& result) {
+    return val(static_cast<double>(result.readI64()));
+}
+
+// Hand each call of a batch its result: callback(value) on success,
+// callback(null, message) when the call or the whole batch failed
+void onRpcResponse(int batch, const std::string& body, const std::string& error) {
+    auto it = g_rpcInFlight.find(batch);
+    if (it == g_rpcInFlight.end()) {
+        return;
+    }
+    std::vector<RpcCall> calls = std::move(it->second);
+    g_rpcInFlight.erase(it);
+
+    RpcReader in(body);
+    std::string batchError = error;
+    if (batchError.empty() && in.readU16() != calls.size()) {
+        batchError = "malformed RPC response";
+    }
+    for (RpcCall& call : calls) {
+        if (!batchError.empty()) {
+            call.callback(val::null(), val(batchError));
+            continue;
+        }
+        RpcStatus status = static_cast<RpcStatus>(in.readU8());
+        RpcReader result(in.readBlock());
+        if (in.failed()) {
+            batchError = "malformed RPC response";
+            call.callback(val::null(), val(batchError));
+        } else if (status != RpcStatus::OK) {
+            call.callback(val::null(), val(std::string(rpcStatusMessage(status))));
+        } else {
+            val value = call.decode(result);
+            if (result.failed()) {
+                call.callback(val::null(), val(std::string("malformed RPC result")));
+            } else {
+                call.callback(value);
+            }
+        }
+    }
+}
+
 // Simple C++ class that will be exposed to JavaScript
 class MetalClient {
 private:
     std::string serverUrl;
     int messageCount;
 
+    // RPC calls queued since the last flush, already encoded as a request
+    std::string rpcRequest;
+    std::vector<RpcCall> rpcCalls;
+    long rpcFrameRequest = 0;   // Pending animation frame, or 0
+    int rpcBatchCount = 0;
+
+    // Start a call's entry in the request; returns the argument block
+    size_t beginCall(RpcMethod method, val callback, val (*decode)(RpcReader&)) {
+        if (rpcCalls.empty()) {
+            RpcWriter(rpcRequest).writeU16(0);  // Call count, set when flushed
+        }
+        RpcWriter out(rpcRequest);
+        out.writeU16(static_cast<uint16_t>(method));
+        rpcCalls.push_back({std::move(callback), decode});
+        return out.beginBlock();
+    }
+
+    // Close the argument block; the batch goes out on the next frame
+    void endCall(size_t block) {
+        RpcWriter(rpcRequest).endBlock(block);
+        if (rpcCalls.size() == kRpcMaxBatch) {
+            flushCalls();
+        } else if (!rpcFrameRequest) {
+            rpcFrameRequest = emscripten_request_animation_frame(&MetalClient::onFrame, this);
+        }
+    }
+
+    static bool onFrame(double, void* userData) {
+        MetalClient* client = static_cast<MetalClient*>(userData);
+        client->rpcFrameRequest = 0;
+        client->flushCalls();
+        return false;
+    }
+
 public:
     MetalClient(const std::string& url) 
         : serverUrl(url), messageCount(0) {
         std::cout << "MetalClient initialized with URL: " << url << std::endl;
     }
 
+    ~MetalClient() {
+        if (rpcFrameRequest) {
+            emscripten_cancel_animation_frame(rpcFrameRequest);
+        }
+    }
+
+    // Server greeting, through the batched RPC: callback(message)
+    void hello(const std::string& name, val callback) {
+        size_t block = beginCall(RpcMethod::HELLO, std::move(callback), decodeString);
+        RpcWriter(rpcRequest).writeString(name);
+        endCall(block);
+    }
+
+    // Server clock in unix seconds, through the batched RPC: callback(seconds)
+    void serverTime(val callback) {
+        size_t block = beginCall(RpcMethod::SERVER_TIME, std::move(callback), decodeI64);
+        endCall(block);
+    }
+
+    // Send every queued call now, in one request, instead of on the next frame
+    void flushCalls() {
+        if (rpcCalls.empty()) {
+            return;
+        }
+        uint16_t count = static_cast<uint16_t>(rpcCalls.size());
+        rpcRequest[0] = static_cast<char>(count & 0xFF);
+        rpcRequest[1] = static_cast<char>(count >> 8);
+
+        int batch = g_nextRpcBatch++;
+        g_rpcInFlight.emplace(batch, std::move(rpcCalls));
+        rpcCalls.clear();
+        rpcBatchCount++;
+
+        std::string url = serverUrl;
+        while (!url.empty() && url.back() == '/') {
+            url.pop_back();
+        }
+        url += "/api/rpc";
+        js_postRpcBatch(url.c_str(), rpcRequest.data(), static_cast<int>(rpcRequest.size()), batch);
+        rpcRequest.clear();
+    }
+
+    // Number of RPC requests sent so far (one per frame with calls)
+    int getRpcBatchCount() const {
+        return rpcBatchCount;
+    }
+
     // Get a greeting from C++
     std::string greet(const std::string& name) {
         messageCount++;
@@ -92,11 +251,16 @@ EMSCRIPTEN_BINDINGS(metal_client_module) {
         .function("getServerUrl", &MetalClient::getServerUrl)
         .function("setServerUrl", &MetalClient::setServerUrl)
         .function("getMessageCount", &MetalClient::getMessageCount)
-        .function("resetCount", &MetalClient::resetCount);
+        .function("resetCount", &MetalClient::resetCount)
+        .function("hello", &MetalClient::hello)
+        .function("serverTime", &MetalClient::serverTime)
+        .function("flushCalls", &MetalClient::flushCalls)
+        .function("getRpcBatchCount", &MetalClient::getRpcBatchCount);
 
     // Bind standalone functions
     function("sayHello", &sayHello);
     function("add", &add);
     function("multiply", &multiply);
     function("processWithCallback", &processWithCallback);
+    function("onRpcResponse", &onRpcResponse);
 }
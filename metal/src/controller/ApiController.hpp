@@ -5,32 +5,124 @@
 #include "oatpp/core/macro/codegen.hpp"
 #include "oatpp/core/macro/component.hpp"
 
+#include "cache/ResponseCache.hpp"
+#include "json/JsonWriter.hpp"
+#include "rpc/RpcDispatcher.hpp"
+
+#include <chrono>
+#include <ctime>
+#include <string>
+#include <string_view>
+
 #include OATPP_CODEGEN_BEGIN(ApiController)
 
 /**
  * API Controller
  */
 class ApiController : public oatpp::web::server::api::ApiController {
+private:
+  RpcDispatcher m_rpc;
+  std::shared_ptr<ResponseCache> m_cache;
+
+  // Endpoints that opt into m_cache, and how long their responses stay fresh
+  static constexpr std::chrono::seconds kHelloTtl{60};
+
+  static std::string helloMessage(const std::string& name) {
+    return "Hello, " + name + "!";
+  }
+
+  // Constant parts of the fixed-shape JSON responses, around their values
+  static constexpr std::string_view kHealthHead = "{\"status\":\"healthy\",\"timestamp\":\"";
+  static constexpr std::string_view kHealthTail = "\"}";
+  static constexpr std::string_view kHelloHead = "{\"message\":\"Hello, ";  // helloMessage(), escaped
+  static constexpr std::string_view kHelloTail = "!\",\"endpoint\":\"/api/hello\"}";
+
+  // 200 with the document just written to the thread's JsonWriter buffer
+  std::shared_ptr<OutgoingResponse> createJsonResponse(const JsonWriter& json) {
+    auto response = createResponse(Status::CODE_200,
+                                   oatpp::String(json.data(), static_cast<v_buff_size>(json.size())));
+    response->putHeader(Header::CONTENT_TYPE, "application/json");
+    return response;
+  }
+
+  // Response for `key` from the cache, rendering it (once, however many
+  // requests ask concurrently) when it is missing or stale. X-Cache tells
+  // which happened.
+  template <typename F>
+  std::shared_ptr<OutgoingResponse> cached(const std::string& key, std::chrono::milliseconds ttl, F&& render) {
+    ResponseCache::Outcome outcome;
+    auto entry = m_cache->getOrRender(key, ttl, std::forward<F>(render), &outcome);
+    auto response = createResponse(entry->status, entry->body);
+    response->putHeader(Header::CONTENT_TYPE, entry->contentType);
+    response->putHeader("X-Cache", outcome == ResponseCache::Outcome::HIT ? "HIT"
+                                   : outcome == ResponseCache::Outcome::MISS ? "MISS" : "COALESCED");
+    return response;
+  }
+
 public:
-  ApiController(OATPP_COMPONENT(std::shared_ptr<ObjectMapper>, objectMapper))
-    : oatpp::web::server::api::ApiController(objectMapper)
-  {}
+  ApiController(OATPP_COMPONENT(std::shared_ptr<ObjectMapper>, objectMapper),
+                OATPP_COMPONENT(std::shared_ptr<ResponseCache>, responseCache))
+    : oatpp::web::server::api::ApiController(objectMapper), m_cache(responseCache)
+  {
+    m_rpc.add(RpcMethod::HELLO, [](RpcReader& args, RpcWriter& result) {
+      result.writeString(helloMessage(args.readString()));
+      return RpcStatus::OK;
+    });
+    m_rpc.add(RpcMethod::SERVER_TIME, [](RpcReader&, RpcWriter& result) {
+      result.writeI64(static_cast<int64_t>(std::time(nullptr)));
+      return RpcStatus::OK;
+    });
+  }
   
+  // Hot read endpoints: fixed shapes, so they skip the ObjectMapper and are
+  // written compact from precomputed parts (same fields and order as before)
   ENDPOINT("GET", "/health", health) {
-    auto dto = oatpp::Fields<oatpp::String>({
-      {"status", "healthy"},
-      {"timestamp", std::to_string(std::time(nullptr))}
-    });
-    return createDtoResponse(Status::CODE_200, dto);
+    JsonWriter json;
+    json.raw(kHealthHead).integer(static_cast<int64_t>(std::time(nullptr))).raw(kHealthTail);
+    return createJsonResponse(json);
   }
   
   ENDPOINT("GET", "/api/hello", hello,
            QUERY(String, name, "name", "World")) {
-    auto dto = oatpp::Fields<oatpp::String>({
-      {"message", "Hello, " + name + "!"},
-      {"endpoint", "/api/hello"}
+    return cached("/api/hello?name=" + *name, kHelloTtl, [&name]() {
+      JsonWriter json;
+      json.raw(kHelloHead).escaped(*name).raw(kHelloTail);
+      return ResponseCache::Entry{Status::CODE_200,
+                                  oatpp::String(json.data(), static_cast<v_buff_size>(json.size())),
+                                  "application/json"};
     });
-    return createDtoResponse(Status::CODE_200, dto);
+  }
+  
+  /**
+   * Response cache counters, for tuning capacity and TTLs
+   */
+  ENDPOINT("GET", "/api/cache/stats", cacheStats) {
+    ResponseCache::Stats stats = m_cache->stats();
+    JsonWriter json;
+    json.raw("{\"hits\":").integer(static_cast<int64_t>(stats.hits))
+        .raw(",\"misses\":").integer(static_cast<int64_t>(stats.misses))
+        .raw(",\"coalesced\":").integer(static_cast<int64_t>(stats.coalesced))
+        .raw(",\"evictions\":").integer(static_cast<int64_t>(stats.evictions))
+        .raw(",\"expirations\":").integer(static_cast<int64_t>(stats.expirations))
+        .raw(",\"entries\":").integer(static_cast<int64_t>(stats.entries))
+        .raw(",\"capacity\":").integer(static_cast<int64_t>(stats.capacity))
+        .raw("}");
+    return createJsonResponse(json);
+  }
+  
+  /**
+   * Batched binary RPC (see rpc/RpcProtocol.hpp): every call of the body
+   * runs here and all results go back in one response
+   */
+  ENDPOINT("POST", "/api/rpc", rpc,
+           BODY_STRING(String, body)) {
+    std::string result;
+    if (!body || !m_rpc.dispatch(*body, result)) {
+      return createResponse(Status::CODE_400, "Malformed RPC batch");
+    }
+    auto response = createResponse(Status::CODE_200, oatpp::String(std::move(result)));
+    response->putHeader(Header::CONTENT_TYPE, "application/octet-stream");
+    return response;
   }
 
 };
@@ -4,105 +4,149 @@
 #include "oatpp/web/server/api/ApiController.hpp"
 #include "oatpp/core/macro/codegen.hpp"
 #include "oatpp/core/macro/component.hpp"
-#include "oatpp/core/data/stream/BufferStream.hpp"
 
-#include <fstream>
-#include <sstream>
-#include <vector>
+#include "asset/AssetIndex.hpp"
+#include "asset/EmbeddedBody.hpp"
+
+#include <memory>
+#include <string>
 
 #include OATPP_CODEGEN_BEGIN(ApiController)
 
 /**
  * Static File Controller - Serves the WebAssembly client
+ *
+ * Files come from an AssetIndex built at startup: a request is one hash
+ * lookup, and headers and bodies are shared rather than rebuilt per request.
+ * Embedded files are served from the executable's read-only data.
+ *
+ * The root document carries Link: rel=preload headers for the assets listed
+ * in the build manifest (asset-manifest.json, written by build.sh), so the
+ * JS glue and the wasm download while the HTML is still being parsed.
  */
 class StaticController : public oatpp::web::server::api::ApiController {
 private:
-  std::string m_staticPath;
-  
-  // Helper to read file content
-  oatpp::String readFile(const std::string& path) {
-    std::ifstream file(path, std::ios::binary | std::ios::ate);
-    if (!file.is_open()) {
-      OATPP_LOGD("StaticController", "Failed to open file: %s", path.c_str());
+  std::shared_ptr<const AssetIndex> m_assets;
+  oatpp::String m_rootLinks;  // Link header value for "/", or nullptr
+
+  // One Link header value for the manifest's "preload" entries. Entries
+  // that are not in the index are skipped.
+  oatpp::String buildPreloadLinks(const std::shared_ptr<ObjectMapper>& objectMapper) {
+    auto manifest = m_assets->find("asset-manifest.json");
+    if (!manifest) {
+      return nullptr;
+    }
+
+    using Entries = oatpp::Vector<oatpp::Fields<oatpp::String>>;
+    oatpp::Fields<Entries> parsed;
+    try {
+      parsed = objectMapper->readFromString<oatpp::Fields<Entries>>(manifest->text());
+    } catch (const std::exception& e) {
+      OATPP_LOGE("StaticController", "Ignoring asset-manifest.json: %s", e.what());
       return nullptr;
     }
-    
-    // Get file size
-    std::streamsize size = file.tellg();
-    file.seekg(0, std::ios::beg);
-    
-    // Read into vector (handles binary data properly)
-    std::vector<char> buffer(size);
-    if (!file.read(buffer.data(), size)) {
-      OATPP_LOGD("StaticController", "Failed to read file: %s", path.c_str());
+    if (!parsed) {
       return nullptr;
     }
-    
-    OATPP_LOGD("StaticController", "Read %ld bytes from: %s", size, path.c_str());
-    
-    // Create oatpp::String with data and size (copies data internally)
-    return oatpp::String((const char*)buffer.data(), size);
+
+    std::string links;
+    for (const auto& section : *parsed) {
+      if (section.first != "preload" || !section.second) {
+        continue;
+      }
+      for (const auto& entry : *section.second) {
+        oatpp::String href, as, type;
+        for (const auto& field : *entry) {
+          if (field.first == "href") href = field.second;
+          else if (field.first == "as") as = field.second;
+          else if (field.first == "type") type = field.second;
+        }
+        if (!href || !as || !m_assets->find(*href)) {
+          continue;
+        }
+        if (!links.empty()) {
+          links += ", ";
+        }
+        links += "<" + *href + ">; rel=preload; as=" + *as;
+        if (type) {
+          links += "; type=\"" + *type + "\"";
+        }
+        if (*as == "fetch") {
+          links += "; crossorigin";  // fetch() requests are CORS-mode; match them
+        }
+      }
+    }
+    return links.empty() ? nullptr : oatpp::String(links);
   }
-  
-  // Get content type based on file extension
-  oatpp::String getContentType(const oatpp::String& path) {
-    if (path->find(".html") != std::string::npos) return "text/html";
-    if (path->find(".js") != std::string::npos) return "application/javascript";
-    if (path->find(".wasm") != std::string::npos) return "application/wasm";
-    if (path->find(".css") != std::string::npos) return "text/css";
-    if (path->find(".json") != std::string::npos) return "application/json";
-    if (path->find(".png") != std::string::npos) return "image/png";
-    if (path->find(".jpg") != std::string::npos || path->find(".jpeg") != std::string::npos) return "image/jpeg";
-    if (path->find(".svg") != std::string::npos) return "image/svg+xml";
-    return "application/octet-stream";
+
+  // 200 with the asset's bytes: embedded files straight from the read-only
+  // data, files read from disk from their shared string
+  std::shared_ptr<OutgoingResponse> createAssetResponse(const Asset& asset, bool gzip) {
+    if (!asset.isEmbedded()) {
+      return createResponse(Status::CODE_200, gzip ? asset.gzipBody : asset.body);
+    }
+    auto body = gzip ? std::make_shared<EmbeddedBody>(asset.gzipData, asset.gzipSize)
+                     : std::make_shared<EmbeddedBody>(asset.data, asset.size);
+    return oatpp::web::protocol::http::outgoing::ResponseFactory::createResponse(Status::CODE_200, body);
+  }
+
+  // 200 with the asset (gzipped when it has a variant and the client takes
+  // it), or 304 when the client's copy is current
+  std::shared_ptr<OutgoingResponse> serve(const Asset& asset,
+                                          const std::shared_ptr<IncomingRequest>& request) {
+    auto acceptEncoding = request->getHeader("Accept-Encoding");
+    bool gzip = asset.hasGzip() && acceptEncoding && acceptEncoding->find("gzip") != std::string::npos;
+    const oatpp::String& etag = gzip ? asset.gzipEtag : asset.etag;
+
+    auto ifNoneMatch = request->getHeader("If-None-Match");
+    bool notModified = ifNoneMatch &&
+        (*ifNoneMatch == "*" || ifNoneMatch->find(*etag) != std::string::npos);
+
+    auto response = notModified
+        ? createResponse(Status::CODE_304, "")
+        : createAssetResponse(asset, gzip);
+    for (const auto& header : asset.headers) {
+      response->putHeader(header.first, header.second);
+    }
+    response->putHeader("ETag", etag);
+    if (gzip) {
+      response->putHeader("Content-Encoding", "gzip");
+    }
+    return response;
   }
 
 public:
-  StaticController(const std::string& staticPath, OATPP_COMPONENT(std::shared_ptr<ObjectMapper>, objectMapper))
-    : oatpp::web::server::api::ApiController(objectMapper), m_staticPath(staticPath)
-  {}
+  StaticController(std::shared_ptr<const AssetIndex> assets,
+                   OATPP_COMPONENT(std::shared_ptr<ObjectMapper>, objectMapper))
+    : oatpp::web::server::api::ApiController(objectMapper), m_assets(std::move(assets))
+  {
+    m_rootLinks = buildPreloadLinks(objectMapper);
+  }
   
   // Serve index.html at root
-  ENDPOINT("GET", "/", root) {
-    std::string indexPath = m_staticPath + "/index.html";
-    OATPP_LOGD("StaticController", "Attempting to serve: %s", indexPath.c_str());
-    
-    auto content = readFile(indexPath);
-    if (!content) {
+  ENDPOINT("GET", "/", root,
+           REQUEST(std::shared_ptr<IncomingRequest>, request)) {
+    auto asset = m_assets->find("");
+    if (!asset) {
       return createResponse(Status::CODE_404, "Client app not found. Please build it first with: cd metal/src/client && ./build.sh");
     }
-    
-    auto response = createResponse(Status::CODE_200, content);
-    response->putHeader(Header::CONTENT_TYPE, "text/html");
+    auto response = serve(*asset, request);
+    if (m_rootLinks) {
+      response->putHeader("Link", m_rootLinks);
+    }
     return response;
   }
   
-  // Serve static files
-  ENDPOINT("GET", "/{filename}", getFile,
-           PATH(String, filename)) {
-    // Security: prevent directory traversal
-    if (filename->find("..") != std::string::npos) {
-      return createResponse(Status::CODE_403, "Forbidden");
-    }
-    
-    std::string fullPath = m_staticPath + "/" + filename->c_str();
-    OATPP_LOGD("StaticController", "Attempting to serve: %s", fullPath.c_str());
-    
-    auto content = readFile(fullPath);
-    
-    if (!content) {
-      std::string msg = "File not found: " + std::string(filename->c_str());
+  // Serve static files, nested paths included
+  ENDPOINT("GET", "/*", getFile,
+           REQUEST(std::shared_ptr<IncomingRequest>, request)) {
+    auto tail = request->getPathTail();
+    auto asset = tail ? m_assets->find(*tail) : nullptr;
+    if (!asset) {
+      std::string msg = "File not found: " + (tail ? *tail : std::string());
       return createResponse(Status::CODE_404, msg.c_str());
     }
-    
-    auto response = createResponse(Status::CODE_200, content);
-    response->putHeader(Header::CONTENT_TYPE, getContentType(filename));
-    
-    // Add CORS headers for WebAssembly
-    response->putHeader("Cross-Origin-Opener-Policy", "same-origin");
-    response->putHeader("Cross-Origin-Embedder-Policy", "require-corp");
-    
-    return response;
+    return serve(*asset, request);
   }
 };
 
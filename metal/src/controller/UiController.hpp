@@ -0,0 +1,36 @@
+#ifndef UiController_hpp
+#define UiController_hpp
+
+#include "oatpp/web/server/api/ApiController.hpp"
+#include "oatpp/core/macro/codegen.hpp"
+#include "oatpp/core/macro/component.hpp"
+
+#include "oatpp-websocket/Handshaker.hpp"
+
+#include OATPP_CODEGEN_BEGIN(ApiController)
+
+/**
+ * UI Controller - WebSocket endpoint of the server-driven view
+ *
+ * Upgrades /ui and hands the socket to the "websocket" ConnectionHandler
+ * (see AppComponent), which runs one UiSession per socket.
+ */
+class UiController : public oatpp::web::server::api::ApiController {
+private:
+  OATPP_COMPONENT(std::shared_ptr<oatpp::network::ConnectionHandler>, m_websocketConnectionHandler, "websocket");
+
+public:
+  UiController(OATPP_COMPONENT(std::shared_ptr<ObjectMapper>, objectMapper))
+    : oatpp::web::server::api::ApiController(objectMapper)
+  {}
+
+  ENDPOINT("GET", "/ui", ui,
+           REQUEST(std::shared_ptr<IncomingRequest>, request)) {
+    return oatpp::websocket::Handshaker::serversideHandshake(request->getHeaders(), m_websocketConnectionHandler);
+  }
+
+};
+
+#include OATPP_CODEGEN_END(ApiController)
+
+#endif /* UiController_hpp */
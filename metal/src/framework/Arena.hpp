@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+// ============================================================================
+// Arena - Bump allocator with chunk reuse
+// ============================================================================
+// Allocations are never freed individually; reset() rewinds the arena and
+// keeps every chunk, so after warm-up a frame allocates no heap memory.
+class Arena {
+public:
+    explicit Arena(size_t chunkSize = 64 * 1024) : chunkSize(chunkSize) {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        while (active < chunks.size()) {
+            Chunk& chunk = chunks[active];
+            size_t start = alignUp(offset, align);
+            if (start + size <= chunk.size) {
+                offset = start + size;
+                lastStart = start;
+                return chunk.data.get() + start;
+            }
+            // Current chunk is exhausted, move on to the next retained one
+            ++active;
+            offset = 0;
+        }
+
+        size_t newSize = size + align > chunkSize ? size + align : chunkSize;
+        chunks.push_back({std::unique_ptr<char[]>(new char[newSize]), newSize});
+        active = chunks.size() - 1;
+        offset = 0;
+        return allocate(size, align);
+    }
+
+    // Grow the most recent allocation in place. Returns false if `ptr` is not
+    // the last allocation or the chunk has no room left.
+    bool tryExtend(const void* ptr, size_t oldSize, size_t newSize) {
+        if (active >= chunks.size()) {
+            return false;
+        }
+        Chunk& chunk = chunks[active];
+        if (ptr != chunk.data.get() + lastStart || lastStart + oldSize != offset) {
+            return false;
+        }
+        if (lastStart + newSize > chunk.size) {
+            return false;
+        }
+        offset = lastStart + newSize;
+        return true;
+    }
+
+    // Rewind to the first chunk. Everything allocated before is invalidated.
+    void reset() {
+        active = 0;
+        offset = 0;
+        lastStart = 0;
+    }
+
+    size_t capacity() const {
+        size_t total = 0;
+        for (const auto& chunk : chunks) {
+            total += chunk.size;
+        }
+        return total;
+    }
+
+private:
+    struct Chunk {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    static size_t alignUp(size_t value, size_t align) {
+        return (value + align - 1) & ~(align - 1);
+    }
+
+    std::vector<Chunk> chunks;
+    size_t chunkSize;
+    size_t active = 0;
+    size_t offset = 0;
+    size_t lastStart = 0;
+};
+
+// ============================================================================
+// FrameArena - Double-buffered arena for render-time data
+// ============================================================================
+// The renderer keeps the previous VNode tree alive to diff against, so data
+// produced during render must outlive one frame. Two arenas alternate:
+// beginFrame() switches to the other one and resets it, which only drops data
+// from two renders ago.
+class FrameArena {
+public:
+    void beginFrame() {
+        index ^= 1;
+        buffers[index].reset();
+    }
+
+    // Give up on the current frame's tree: the next beginFrame() reuses its
+    // buffer rather than the one still backing the previous tree
+    void abandonFrame() {
+        index ^= 1;
+    }
+
+    Arena& current() {
+        return buffers[index];
+    }
+
+private:
+    Arena buffers[2];
+    int index = 0;
+};
+
+inline FrameArena& frameArena() {
+    static FrameArena instance;
+    return instance;
+}
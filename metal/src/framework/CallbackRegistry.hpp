@@ -0,0 +1,138 @@
+#pragma once
+
+#include "SmallFunction.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// ============================================================================
+// CallbackRegistry - Persistent event handler slots
+// ============================================================================
+// Handlers live in slots that survive across renders. An ID packs the slot
+// index with the slot's generation, so an ID from a freed slot never reaches
+// whatever handler reuses the slot later.
+//
+// Every render marks the slots it uses. Registering a handler identical to
+// one already in a slot (see SmallFunction::sameAs) marks and returns that
+// slot, so the ID and the DOM attribute it is rendered into stay the same.
+// commit() frees the slots the committed render did not mark. A slot stays
+// callable until then, because the DOM still refers to it.
+template <typename Signature>
+class CallbackRegistry {
+public:
+    using Function = SmallFunction<Signature>;
+
+    static constexpr int kIndexBits = 20;
+    static constexpr uint32_t kIndexMask = (1u << kIndexBits) - 1;
+    static constexpr uint32_t kGenerationMask = (1u << (31 - kIndexBits)) - 1;
+
+    // Returns the handler's ID, or -1 if every slot is taken
+    template <typename F>
+    int add(F&& callable) {
+        Function function(std::forward<F>(callable));
+        size_t hash = 0;
+        if (function.comparable()) {
+            hash = function.stateHash();
+            auto it = byHash.find(hash);
+            if (it != byHash.end() && slots[it->second].function.sameAs(function)) {
+                slots[it->second].marked = true;
+                return makeId(it->second);
+            }
+        }
+
+        uint32_t index;
+        if (!freeSlots.empty()) {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        } else if (slots.size() <= kIndexMask) {
+            index = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        } else {
+            return -1;
+        }
+
+        Slot& slot = slots[index];
+        slot.function = std::move(function);
+        slot.used = true;
+        slot.marked = true;
+        if (slot.function.comparable()) {
+            slot.hash = hash;
+            byHash[hash] = index;  // A colliding older slot just stops being shared
+        }
+        return makeId(index);
+    }
+
+    template <typename... Args>
+    void invoke(int id, Args&&... args) const {
+        if (id < 0) {
+            return;
+        }
+        uint32_t index = static_cast<uint32_t>(id) & kIndexMask;
+        uint32_t generation = static_cast<uint32_t>(id) >> kIndexBits;
+        if (index < slots.size() && slots[index].used && slots[index].generation == generation) {
+            slots[index].function(std::forward<Args>(args)...);
+        }
+    }
+
+    // Keep a handler registered by an earlier render, for a subtree that is
+    // reused without rendering it again
+    void mark(int id) {
+        if (id < 0) {
+            return;
+        }
+        uint32_t index = static_cast<uint32_t>(id) & kIndexMask;
+        uint32_t generation = static_cast<uint32_t>(id) >> kIndexBits;
+        if (index < slots.size() && slots[index].used && slots[index].generation == generation) {
+            slots[index].marked = true;
+        }
+    }
+
+    // A render is starting: it marks the slots it still needs
+    void beginFrame() {
+        for (Slot& slot : slots) {
+            slot.marked = false;
+        }
+    }
+
+    // The last render is in the DOM: free whatever it did not use
+    void commit() {
+        for (uint32_t index = 0; index < slots.size(); ++index) {
+            Slot& slot = slots[index];
+            if (slot.used && !slot.marked) {
+                release(index);
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        Function function;
+        size_t hash = 0;
+        uint32_t generation = 0;
+        bool used = false;
+        bool marked = false;   // Used by the render in progress or just committed
+    };
+
+    int makeId(uint32_t index) const {
+        return static_cast<int>((slots[index].generation << kIndexBits) | index);
+    }
+
+    void release(uint32_t index) {
+        Slot& slot = slots[index];
+        if (slot.function.comparable()) {
+            auto it = byHash.find(slot.hash);
+            if (it != byHash.end() && it->second == index) {
+                byHash.erase(it);
+            }
+        }
+        slot.function.reset();
+        slot.used = false;
+        slot.generation = (slot.generation + 1) & kGenerationMask;
+        freeSlots.push_back(index);
+    }
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::unordered_map<size_t, uint32_t> byHash;
+};
@@ -1,10 +1,14 @@
 #pragma once
 
 #include "VNode.hpp"
+#include "TaskPool.hpp"
 #include <vector>
 #include <map>
 #include <string>
 #include <optional>
+#ifdef FRAMEWORK_VERIFY_HASHES
+#include <cstdio>
+#endif
 
 // ============================================================================
 // Diff Operations
@@ -18,14 +22,15 @@ enum class DiffOp {
 // Update flags - bit-based for flexibility
 enum UpdateFlags : uint8_t {
     UPDATE_PROPS    = 1 << 0,  // Props changed
-    UPDATE_CHILDREN = 1 << 1   // Children changed (additions, removals, or updates)
+    UPDATE_CHILDREN = 1 << 1,  // Children changed (additions, removals, or updates)
+    UPDATE_STYLE    = 1 << 2   // Individual style properties changed
 };
 
 // ============================================================================
 // PropDiff - Describes changes to props
 // ============================================================================
 struct PropDiff {
-    std::map<std::string, std::string> added;      // New props or changed values
+    std::map<std::string, PropValue> added;        // New props or changed values
     std::vector<std::string> removed;               // Props that were removed
     
     bool isEmpty() const {
@@ -46,6 +51,9 @@ struct DiffNode {
     // For UPDATE with UPDATE_PROPS flag: the prop changes
     std::optional<PropDiff> propDiff;
     
+    // For UPDATE with UPDATE_STYLE flag: the style property changes
+    std::optional<PropDiff> styleDiff;
+    
     // For UPDATE with UPDATE_CHILDREN flag: map of child index -> DiffNode
     std::map<size_t, DiffNode> childrenDiff;
     
@@ -66,15 +74,18 @@ struct DiffNode {
     bool hasChildrenChanged() const {
         return op == DiffOp::UPDATE && (updateFlags & UPDATE_CHILDREN);
     }
+    
+    bool hasStyleChanged() const {
+        return op == DiffOp::UPDATE && (updateFlags & UPDATE_STYLE);
+    }
 };
 
 // ============================================================================
 // Diff Algorithm
 // ============================================================================
 
-// Compare props of two nodes
-PropDiff diffProps(const std::map<std::string, std::string>& oldProps, 
-                   const std::map<std::string, std::string>& newProps) {
+// Compare props of two nodes (also used for style maps)
+PropDiff diffProps(const Props& oldProps, const Props& newProps) {
     PropDiff result;
     
     auto oldIt = oldProps.begin();
@@ -114,6 +125,47 @@ PropDiff diffProps(const std::map<std::string, std::string>& oldProps,
 // Forward declaration
 DiffNode diffNodes(const VNode& oldNode, const VNode& newNode);
 
+// Node pairs compared on this thread, for FrameStats. Per thread so that
+// worker and pool threads count without contention.
+inline uint32_t& diffVisitCounter() {
+    thread_local uint32_t count = 0;
+    return count;
+}
+
+// Read and reset this thread's visit count
+inline uint32_t takeDiffVisits() {
+    uint32_t count = diffVisitCounter();
+    diffVisitCounter() = 0;
+    return count;
+}
+
+// Record children past the common length as additions or removals
+void diffChildrenTail(const std::vector<VNode>& oldChildren,
+                      const std::vector<VNode>& newChildren,
+                      std::vector<VNode>& addedChildren,
+                      std::vector<size_t>& removedIndices) {
+    // Handle additions (new children beyond old length)
+    if (newChildren.size() > oldChildren.size()) {
+        for (size_t i = oldChildren.size(); i < newChildren.size(); ++i) {
+            addedChildren.push_back(newChildren[i]);
+        }
+    }
+    
+    // Handle removals (old children beyond new length)
+    if (oldChildren.size() > newChildren.size()) {
+        for (size_t i = newChildren.size(); i < oldChildren.size(); ++i) {
+            removedIndices.push_back(i);
+        }
+    }
+}
+
+#ifdef FRAMEWORK_PTHREADS
+// Sibling lists at least this wide are diffed in parallel, in chunks of
+// at least kParallelDiffGrain children
+constexpr size_t kParallelDiffMinChildren = 32;
+constexpr size_t kParallelDiffGrain = 8;
+#endif
+
 // Diff children recursively
 std::map<size_t, DiffNode> diffChildren(const std::vector<VNode>& oldChildren,
                                         const std::vector<VNode>& newChildren,
@@ -123,6 +175,33 @@ std::map<size_t, DiffNode> diffChildren(const std::vector<VNode>& oldChildren,
     
     size_t minSize = std::min(oldChildren.size(), newChildren.size());
     
+#ifdef FRAMEWORK_PTHREADS
+    // Wide lists are split across the task pool. Each chunk writes its own
+    // slots, and the merge below walks them in index order, so the result
+    // is identical to the serial loop whatever the scheduling was.
+    TaskPool* pool = TaskPool::current();
+    if (pool && pool->size() > 0 && minSize >= kParallelDiffMinChildren) {
+        std::vector<DiffNode> slots(minSize);
+        std::atomic<uint32_t> visits{0};
+        pool->parallelFor(minSize, kParallelDiffGrain, [&](size_t begin, size_t end) {
+            uint32_t before = diffVisitCounter();
+            for (size_t i = begin; i < end; ++i) {
+                slots[i] = diffNodes(oldChildren[i], newChildren[i]);
+            }
+            visits.fetch_add(diffVisitCounter() - before, std::memory_order_relaxed);
+            diffVisitCounter() = before;
+        });
+        diffVisitCounter() += visits.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < minSize; ++i) {
+            if (slots[i].hasChanges()) {
+                result.emplace_hint(result.end(), i, std::move(slots[i]));
+            }
+        }
+        diffChildrenTail(oldChildren, newChildren, addedChildren, removedIndices);
+        return result;
+    }
+#endif
+    
     // Compare existing children at same positions
     for (size_t i = 0; i < minSize; ++i) {
         DiffNode childDiff = diffNodes(oldChildren[i], newChildren[i]);
@@ -131,61 +210,87 @@ std::map<size_t, DiffNode> diffChildren(const std::vector<VNode>& oldChildren,
         }
     }
     
-    // Handle additions (new children beyond old length)
-    if (newChildren.size() > oldChildren.size()) {
-        for (size_t i = oldChildren.size(); i < newChildren.size(); ++i) {
-            addedChildren.push_back(newChildren[i]);
+    diffChildrenTail(oldChildren, newChildren, addedChildren, removedIndices);
+    
+    return result;
+}
+
+#ifdef FRAMEWORK_VERIFY_HASHES
+// Full structural comparison, to check the subtrees skipped on a hash match
+bool sameSubtree(const VNode& oldRef, const VNode& newRef) {
+    const VNode& oldNode = oldRef.resolved();
+    const VNode& newNode = newRef.resolved();
+    if (oldNode.tag != newNode.tag || oldNode.props != newNode.props ||
+        oldNode.styles != newNode.styles || oldNode.children.size() != newNode.children.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < oldNode.children.size(); ++i) {
+        if (!sameSubtree(oldNode.children[i], newNode.children[i])) {
+            return false;
         }
     }
+    return true;
+}
+#endif
+
+// Cases decided without looking at props or children. Returns true when
+// `diff` is final; false means both are elements with the same tag.
+bool diffShallow(const VNode& oldRef, const VNode& newRef, DiffNode& diff) {
+    // Case 0: Same hoisted static fragment -> identical by construction
+    if (oldRef.fragment && oldRef.fragment == newRef.fragment) {
+        return true;
+    }
     
-    // Handle removals (old children beyond new length)
-    if (oldChildren.size() > newChildren.size()) {
-        for (size_t i = newChildren.size(); i < oldChildren.size(); ++i) {
-            removedIndices.push_back(i);
+    // Case 0b: Equal structural hashes -> nothing changed in the subtree.
+    // Builds with FRAMEWORK_VERIFY_HASHES check every such skip and fall
+    // through to the full diff on a collision.
+    if (oldRef.subtreeHash() == newRef.subtreeHash()) {
+#ifdef FRAMEWORK_VERIFY_HASHES
+        if (sameSubtree(oldRef, newRef)) {
+            return true;
         }
+        std::fprintf(stderr, "diff: hash collision on %016llx, diffing in full\n",
+                     static_cast<unsigned long long>(newRef.subtreeHash()));
+#else
+        return true;
+#endif
     }
     
-    return result;
-}
-
-// Main diff function
-DiffNode diffNodes(const VNode& oldNode, const VNode& newNode) {
-    DiffNode diff;
+    const VNode& oldNode = oldRef.resolved();
+    const VNode& newNode = newRef.resolved();
     
     // Case 1: Different tags -> REPLACE entire subtree
     if (oldNode.tag != newNode.tag) {
         diff.op = DiffOp::REPLACE;
-        diff.newNode = newNode;
-        return diff;
+        diff.newNode = newRef;
+        return true;
     }
     
     // Case 2: Text nodes -> Check if content changed
     if (oldNode.isText() && newNode.isText()) {
         if (oldNode.getText() != newNode.getText()) {
             diff.op = DiffOp::REPLACE;
-            diff.newNode = newNode;
+            diff.newNode = newRef;
         }
         // If text is same, no changes - return diff with no hasChanges()
-        return diff;
+        return true;
     }
     
-    // Case 3: Same tag (element node) -> Compare props and children
-    PropDiff propDiff = diffProps(oldNode.props, newNode.props);
+    return false;
+}
+
+// Determine the operation from the prop and child changes of an element
+void assembleDiff(DiffNode& diff,
+                  PropDiff&& propDiff,
+                  PropDiff&& styleDiff,
+                  std::map<size_t, DiffNode>&& childrenDiff,
+                  std::vector<VNode>&& addedChildren,
+                  std::vector<size_t>&& removedIndices) {
     bool propsChanged = !propDiff.isEmpty();
-    
-    std::vector<VNode> addedChildren;
-    std::vector<size_t> removedIndices;
-    std::map<size_t, DiffNode> childrenDiff = diffChildren(
-        oldNode.children, 
-        newNode.children,
-        addedChildren,
-        removedIndices
-    );
-    
+    bool styleChanged = !styleDiff.isEmpty();
     bool childrenChanged = !childrenDiff.empty() || !addedChildren.empty() || !removedIndices.empty();
     
-    // Determine the operation
-    if (propsChanged || childrenChanged) {
+    if (propsChanged || styleChanged || childrenChanged) {
         diff.op = DiffOp::UPDATE;
         
         if (propsChanged) {
@@ -193,6 +298,11 @@ DiffNode diffNodes(const VNode& oldNode, const VNode& newNode) {
             diff.propDiff = std::move(propDiff);
         }
         
+        if (styleChanged) {
+            diff.updateFlags |= UPDATE_STYLE;
+            diff.styleDiff = std::move(styleDiff);
+        }
+        
         if (childrenChanged) {
             diff.updateFlags |= UPDATE_CHILDREN;
             diff.childrenDiff = std::move(childrenDiff);
@@ -201,6 +311,35 @@ DiffNode diffNodes(const VNode& oldNode, const VNode& newNode) {
         }
     }
     // else: op remains NONE (no changes)
+}
+
+// Main diff function
+DiffNode diffNodes(const VNode& oldRef, const VNode& newRef) {
+    DiffNode diff;
+    ++diffVisitCounter();
+    
+    if (diffShallow(oldRef, newRef, diff)) {
+        return diff;
+    }
+    
+    // Case 3: Same tag (element node) -> Compare props and children
+    const VNode& oldNode = oldRef.resolved();
+    const VNode& newNode = newRef.resolved();
+    
+    PropDiff propDiff = diffProps(oldNode.props, newNode.props);
+    PropDiff styleDiff = diffProps(oldNode.styles, newNode.styles);
+    
+    std::vector<VNode> addedChildren;
+    std::vector<size_t> removedIndices;
+    std::map<size_t, DiffNode> childrenDiff = diffChildren(
+        oldNode.children, 
+        newNode.children,
+        addedChildren,
+        removedIndices
+    );
+    
+    assembleDiff(diff, std::move(propDiff), std::move(styleDiff), std::move(childrenDiff),
+                 std::move(addedChildren), std::move(removedIndices));
     
     return diff;
 }
@@ -209,3 +348,111 @@ DiffNode diffNodes(const VNode& oldNode, const VNode& newNode) {
 DiffNode diff(const VNode& oldRoot, const VNode& newRoot) {
     return diffNodes(oldRoot, newRoot);
 }
+
+// ============================================================================
+// DiffTask - Interruptible diff with an explicit stack
+// ============================================================================
+// Produces the same DiffNode as diffNodes(), but can stop between nodes and
+// pick up where it left off. Both trees must stay alive and unchanged until
+// the task is done.
+class DiffTask {
+public:
+    DiffTask(const VNode& oldRoot, const VNode& newRoot) {
+        enter(oldRoot, newRoot, 0);
+    }
+    
+    bool done() const {
+        return finished;
+    }
+    
+    // Diff until finished or shouldYield() returns true. The clock is only
+    // consulted every kCheckInterval nodes. Returns true once finished.
+    template <typename ShouldYield>
+    bool run(ShouldYield shouldYield) {
+        size_t sinceCheck = 0;
+        while (!stack.empty()) {
+            if (++sinceCheck >= kCheckInterval) {
+                sinceCheck = 0;
+                if (shouldYield()) {
+                    return false;
+                }
+            }
+            
+            Frame& frame = stack.back();
+            if (frame.nextChild < frame.minSize) {
+                size_t i = frame.nextChild++;
+                enter(frame.oldNode->children[i], frame.newNode->children[i], i);
+            } else {
+                leave();
+            }
+        }
+        return finished;
+    }
+    
+    DiffNode takeResult() {
+        return std::move(result);
+    }
+    
+private:
+    static constexpr size_t kCheckInterval = 32;
+    
+    struct Frame {
+        const VNode* oldNode;   // resolved
+        const VNode* newNode;   // resolved
+        size_t indexInParent;
+        size_t nextChild = 0;
+        size_t minSize = 0;
+        DiffNode diff;
+        PropDiff propDiff;
+        PropDiff styleDiff;
+        std::map<size_t, DiffNode> childrenDiff;
+    };
+    
+    // Start on a node pair: finish it now if shallow, otherwise push a frame
+    void enter(const VNode& oldRef, const VNode& newRef, size_t index) {
+        ++diffVisitCounter();
+        DiffNode diff;
+        if (diffShallow(oldRef, newRef, diff)) {
+            deliver(std::move(diff), index);
+            return;
+        }
+        
+        Frame frame;
+        frame.oldNode = &oldRef.resolved();
+        frame.newNode = &newRef.resolved();
+        frame.indexInParent = index;
+        frame.minSize = std::min(frame.oldNode->children.size(), frame.newNode->children.size());
+        frame.propDiff = diffProps(frame.oldNode->props, frame.newNode->props);
+        frame.styleDiff = diffProps(frame.oldNode->styles, frame.newNode->styles);
+        stack.push_back(std::move(frame));
+    }
+    
+    // All children of the top frame are diffed: assemble it and hand it up
+    void leave() {
+        Frame frame = std::move(stack.back());
+        stack.pop_back();
+        
+        std::vector<VNode> addedChildren;
+        std::vector<size_t> removedIndices;
+        diffChildrenTail(frame.oldNode->children, frame.newNode->children,
+                         addedChildren, removedIndices);
+        
+        assembleDiff(frame.diff, std::move(frame.propDiff), std::move(frame.styleDiff),
+                     std::move(frame.childrenDiff),
+                     std::move(addedChildren), std::move(removedIndices));
+        deliver(std::move(frame.diff), frame.indexInParent);
+    }
+    
+    void deliver(DiffNode diff, size_t index) {
+        if (stack.empty()) {
+            result = std::move(diff);
+            finished = true;
+        } else if (diff.hasChanges()) {
+            stack.back().childrenDiff[index] = std::move(diff);
+        }
+    }
+    
+    std::vector<Frame> stack;
+    DiffNode result;
+    bool finished = false;
+};
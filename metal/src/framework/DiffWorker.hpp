@@ -0,0 +1,115 @@
+#pragma once
+
+// ============================================================================
+// DiffWorker - Runs diff() on a pthread and hands back a patch stream
+// ============================================================================
+// Only available in the threaded build (build.sh --threads), which defines
+// FRAMEWORK_PTHREADS and links with -pthread. The main thread posts two
+// trees, keeps rendering and handling input, and polls once per frame; the
+// worker diffs them and encodes the result with PatchStreamWriter into a
+// buffer in shared memory. The main thread never blocks on the worker.
+//
+// Both trees are read concurrently and must not be touched until poll()
+// reports completion. The worker may wait on sharedTaskPool(), so wide
+// sibling lists are diffed in parallel (see diffChildren).
+#ifdef FRAMEWORK_PTHREADS
+
+#include "Diff.hpp"
+#include "PatchStream.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class DiffWorker {
+public:
+    DiffWorker() : thread([this]() { loop(); }) {}
+
+    ~DiffWorker() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        thread.join();
+    }
+
+    DiffWorker(const DiffWorker&) = delete;
+    DiffWorker& operator=(const DiffWorker&) = delete;
+
+    // Start diffing. Only one job may be in flight at a time.
+    void post(const VNode& oldRoot, const VNode& newRoot) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobOld = &oldRoot;
+            jobNew = &newRoot;
+            finished.store(false, std::memory_order_relaxed);
+        }
+        wake.notify_one();
+    }
+
+    // Time and node pairs of the last finished job, valid after poll()
+    // returned true
+    double lastDiffMs() const {
+        return diffMs;
+    }
+
+    uint32_t lastNodesVisited() const {
+        return nodesVisited;
+    }
+
+    // Non-blocking. Returns true once the posted job is done and moves its
+    // patch stream into `out`.
+    bool poll(std::vector<uint8_t>& out) {
+        if (!finished.load(std::memory_order_acquire)) {
+            return false;
+        }
+        finished.store(false, std::memory_order_relaxed);
+        out.swap(stream);
+        stream.clear();
+        return true;
+    }
+
+private:
+    void loop() {
+        TaskPool::current() = &sharedTaskPool();
+        for (;;) {
+            const VNode* oldRoot;
+            const VNode* newRoot;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this]() { return stopping || jobNew != nullptr; });
+                if (stopping) {
+                    return;
+                }
+                oldRoot = jobOld;
+                newRoot = jobNew;
+                jobOld = jobNew = nullptr;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            DiffNode diff = diffNodes(*oldRoot, *newRoot);
+            encodePatchStream(diff, stream);
+            diffMs = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+            nodesVisited = takeDiffVisits();
+            finished.store(true, std::memory_order_release);
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    const VNode* jobOld = nullptr;
+    const VNode* jobNew = nullptr;
+    bool stopping = false;
+    std::vector<uint8_t> stream;       // Written by the worker until finished
+    double diffMs = 0;                 // Likewise
+    uint32_t nodesVisited = 0;
+    std::atomic<bool> finished{false};
+    std::thread thread;                // Last: starts after the state above
+};
+
+#endif // FRAMEWORK_PTHREADS
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// ============================================================================
+// FrameStats - Per-frame renderer instrumentation
+// ============================================================================
+// The renderer fills in current() while it works and commit()s once per
+// animation frame. Only frames that did something are kept; the last
+// kCapacity of them stay in a ring buffer that JS reads through embind
+// (getFrameStats) for the overlay and for RUM reporting.
+struct FrameStats {
+    uint32_t frame = 0;        // Sequence number, increases by one per record
+    double timestamp = 0;      // performance.now() at the start of the frame
+    double renderMs = 0;       // render() of the component tree
+    double diffMs = 0;         // Main-thread diff slices, or the worker's diff
+    double patchMs = 0;        // DOM writes of the commit
+    uint32_t nodesVisited = 0; // Node pairs compared by the diff
+    uint32_t nodesCreated = 0; // DOM nodes created (a template clone counts once)
+    uint32_t nodesRemoved = 0; // DOM subtrees removed or replaced
+    uint32_t jsCalls = 0;      // wasm -> JS calls made by the patcher
+
+    bool empty() const {
+        return renderMs == 0 && diffMs == 0 && patchMs == 0 &&
+               nodesVisited == 0 && nodesCreated == 0 && nodesRemoved == 0 && jsCalls == 0;
+    }
+};
+
+class FrameStatsRing {
+public:
+    static constexpr size_t kCapacity = 240;
+
+    FrameStats& current() {
+        return pending;
+    }
+
+    // Close the current frame; dropped if nothing was recorded
+    void commit() {
+        if (!pending.empty()) {
+            pending.frame = nextFrame++;
+            ring[(start + count) % kCapacity] = pending;
+            if (count < kCapacity) {
+                ++count;
+            } else {
+                start = (start + 1) % kCapacity;
+            }
+        }
+        pending = FrameStats();
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    // 0 is the oldest frame kept
+    const FrameStats& at(size_t index) const {
+        return ring[(start + index) % kCapacity];
+    }
+
+private:
+    std::array<FrameStats, kCapacity> ring;
+    size_t start = 0;
+    size_t count = 0;
+    uint32_t nextFrame = 1;
+    FrameStats pending;
+};
+
+inline FrameStatsRing& frameStats() {
+    static FrameStatsRing instance;
+    return instance;
+}
+
+inline void countJsCalls(uint32_t calls = 1) {
+    frameStats().current().jsCalls += calls;
+}
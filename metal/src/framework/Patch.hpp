@@ -2,6 +2,8 @@
 
 #include "VNode.hpp"
 #include "Diff.hpp"
+#include "FrameStats.hpp"
+#include <unordered_map>
 #include <emscripten/val.h>
 #include <emscripten/emscripten.h>
 
@@ -11,9 +13,29 @@ using emscripten::EM_VAL;
 // DOM Manipulation - Low-level EM_JS functions
 // ============================================================================
 
-// Create a DOM element by tag name
-EM_JS(EM_VAL, dom_createElement, (const char* tagName), {
-    const element = document.createElement(UTF8ToString(tagName));
+// Decode the tag/attribute name tables once; later calls pass table indices
+EM_JS(void, dom_registerTables, (const char* const* tagNames, int tagCount, int firstSvgTag,
+                                 const char* const* attrNames, const char* const* attrProps,
+                                 int attrCount), {
+    const readNames = (ptr, count) => {
+        const names = new Array(count);
+        for (let i = 0; i < count; i++) {
+            names[i] = UTF8ToString(HEAPU32[(ptr >> 2) + i]);
+        }
+        return names;
+    };
+    Module.fwTagNames = readNames(tagNames, tagCount);
+    Module.fwFirstSvgTag = firstSvgTag;
+    Module.fwAttrNames = readNames(attrNames, attrCount);
+    Module.fwAttrProps = readNames(attrProps, attrCount);
+});
+
+// Create a DOM element by Tag index
+EM_JS(EM_VAL, dom_createElement, (int tagId), {
+    const name = Module.fwTagNames[tagId];
+    const element = tagId >= Module.fwFirstSvgTag
+        ? document.createElementNS("http://www.w3.org/2000/svg", name)
+        : document.createElement(name);
     return Emval.toHandle(element);
 });
 
@@ -35,6 +57,39 @@ EM_JS(void, dom_removeAttribute, (EM_VAL elementHandle, const char* key), {
     element.removeAttribute(UTF8ToString(key));
 });
 
+// Set a known attribute by Attr index
+EM_JS(void, dom_setAttributeById, (EM_VAL elementHandle, int attrId, const char* value), {
+    const element = Emval.toValue(elementHandle);
+    element.setAttribute(Module.fwAttrNames[attrId], UTF8ToString(value));
+});
+
+// Remove a known attribute by Attr index
+EM_JS(void, dom_removeAttributeById, (EM_VAL elementHandle, int attrId), {
+    const element = Emval.toValue(elementHandle);
+    element.removeAttribute(Module.fwAttrNames[attrId]);
+});
+
+// Assign a PROPERTY-kind attribute to its DOM property. Skipped when equal,
+// so re-assigning an input's current value does not move the caret.
+EM_JS(void, dom_setPropertyById, (EM_VAL elementHandle, int attrId, const char* value), {
+    const element = Emval.toValue(elementHandle);
+    const property = Module.fwAttrProps[attrId];
+    const text = UTF8ToString(value);
+    if (element[property] !== text) {
+        element[property] = text;
+    }
+});
+
+EM_JS(void, dom_setBoolPropertyById, (EM_VAL elementHandle, int attrId, int on), {
+    const element = Emval.toValue(elementHandle);
+    element[Module.fwAttrProps[attrId]] = !!on;
+});
+
+EM_JS(void, dom_toggleAttributeById, (EM_VAL elementHandle, int attrId, int on), {
+    const element = Emval.toValue(elementHandle);
+    element.toggleAttribute(Module.fwAttrNames[attrId], !!on);
+});
+
 // Append a child to a parent element
 EM_JS(void, dom_appendChild, (EM_VAL parentHandle, EM_VAL childHandle), {
     const parent = Emval.toValue(parentHandle);
@@ -76,38 +131,166 @@ EM_JS(void, dom_setTextContent, (EM_VAL nodeHandle, const char* text), {
     node.textContent = UTF8ToString(text);
 });
 
+// Set one inline style property; the rest of the style attribute is untouched
+EM_JS(void, dom_setStyleProperty, (EM_VAL elementHandle, const char* name, const char* value), {
+    const element = Emval.toValue(elementHandle);
+    element.style.setProperty(UTF8ToString(name), UTF8ToString(value));
+});
+
+EM_JS(void, dom_removeStyleProperty, (EM_VAL elementHandle, const char* name), {
+    const element = Emval.toValue(elementHandle);
+    element.style.removeProperty(UTF8ToString(name));
+});
+
+// Store a deep copy of an element as the <template> for a shape
+EM_JS(void, dom_registerTemplate, (int shapeId, EM_VAL elementHandle), {
+    const element = Emval.toValue(elementHandle);
+    const template = document.createElement("template");
+    template.content.appendChild(element.cloneNode(true));
+    (Module.fwTemplates || (Module.fwTemplates = []))[shapeId] = template;
+});
+
+// Instantiate a shape's <template>
+EM_JS(EM_VAL, dom_cloneTemplate, (int shapeId), {
+    const template = Module.fwTemplates[shapeId];
+    return Emval.toHandle(template.content.firstChild.cloneNode(true));
+});
+
+// ============================================================================
+// Name Tables - Shared with the JS glue
+// ============================================================================
+
+// Must run before the first element is created
+void registerDomTables() {
+    static bool registered = false;
+    if (!registered) {
+        dom_registerTables(kTagNames, static_cast<int>(kTagCount), static_cast<int>(kFirstSvgTag),
+                           kAttrNames, kAttrPropertyNames.data(), static_cast<int>(kAttrCount));
+        registered = true;
+    }
+}
+
+// Boolean props are on unless explicitly "false" (presence means true)
+bool isPropOn(const PropValue& value) {
+    return value.view() != "false";
+}
+
+// Set a prop on a freshly created element. Attributes are enough here: an
+// untouched element's value/checked state follows its attributes, and
+// <template> clones only copy attributes.
+void initProp(EM_VAL element, const std::string& key, const PropValue& value) {
+    countJsCalls();
+    Attr attr = attrFromName(key);
+    if (attr == Attr::UNKNOWN) {
+        dom_setAttribute(element, key.c_str(), value.c_str());
+        return;
+    }
+    switch (attrKind(attr)) {
+        case AttrKind::BOOLEAN:
+        case AttrKind::BOOLEAN_PROPERTY:
+            dom_toggleAttributeById(element, static_cast<int>(attr), isPropOn(value));
+            break;
+        default:
+            dom_setAttributeById(element, static_cast<int>(attr), value.c_str());
+            break;
+    }
+}
+
+// Update a prop on a live element, dispatched by attribute kind. Properties
+// such as value and checked are assigned directly, since their attributes
+// stop reflecting the element once the user has interacted with it.
+void setProp(EM_VAL element, const std::string& key, const PropValue& value) {
+    countJsCalls();
+    Attr attr = attrFromName(key);
+    if (attr == Attr::UNKNOWN) {
+        dom_setAttribute(element, key.c_str(), value.c_str());
+        return;
+    }
+    int id = static_cast<int>(attr);
+    switch (attrKind(attr)) {
+        case AttrKind::ATTRIBUTE:
+            dom_setAttributeById(element, id, value.c_str());
+            break;
+        case AttrKind::PROPERTY:
+            dom_setPropertyById(element, id, value.c_str());
+            break;
+        case AttrKind::BOOLEAN:
+            dom_toggleAttributeById(element, id, isPropOn(value));
+            break;
+        case AttrKind::BOOLEAN_PROPERTY:
+            dom_setBoolPropertyById(element, id, isPropOn(value));
+            break;
+    }
+}
+
+void removeProp(EM_VAL element, const std::string& key) {
+    countJsCalls();
+    Attr attr = attrFromName(key);
+    if (attr == Attr::UNKNOWN) {
+        dom_removeAttribute(element, key.c_str());
+        return;
+    }
+    int id = static_cast<int>(attr);
+    switch (attrKind(attr)) {
+        case AttrKind::ATTRIBUTE:
+            dom_removeAttributeById(element, id);
+            break;
+        case AttrKind::PROPERTY:
+            dom_setPropertyById(element, id, "");
+            break;
+        case AttrKind::BOOLEAN:
+            dom_toggleAttributeById(element, id, 0);
+            break;
+        case AttrKind::BOOLEAN_PROPERTY:
+            dom_setBoolPropertyById(element, id, 0);
+            break;
+    }
+}
+
 // ============================================================================
 // VNode Rendering - Create DOM from VNode
 // ============================================================================
 
-// Forward declaration
+// Forward declarations
 EM_VAL renderVNode(const VNode& vnode);
+void patchNode(EM_VAL domElement, const DiffNode& diff);
+
+// First rendered instance of each TemplateShape, kept to diff later
+// instances against. Values are owned, the prototype outlives its frame.
+std::unordered_map<uint32_t, VNode> g_templatePrototypes;
 
 // Render children and append to parent
 void renderChildren(EM_VAL parentHandle, const std::vector<VNode>& children) {
     for (const auto& child : children) {
         EM_VAL childHandle = renderVNode(child);
         dom_appendChild(parentHandle, childHandle);
+        countJsCalls();
         emscripten::internal::_emval_decref(childHandle);
     }
 }
 
-// Render a VNode to a DOM element
-EM_VAL renderVNode(const VNode& vnode) {
+// Render a VNode to a DOM element, without template cloning
+EM_VAL renderFresh(const VNode& vnode) {
     EM_VAL elementHandle;
+    frameStats().current().nodesCreated++;
+    countJsCalls();
     
     if (vnode.isText()) {
         // Create text node
         elementHandle = dom_createTextNode(vnode.getText().c_str());
     } else {
         // Create element
-        const char* tagName = tagToString(vnode.tag);
-        elementHandle = dom_createElement(tagName);
+        elementHandle = dom_createElement(static_cast<int>(vnode.tag));
         
         // Set attributes
         for (const auto& [key, value] : vnode.props) {
-            dom_setAttribute(elementHandle, key.c_str(), value.c_str());
+            initProp(elementHandle, key, value);
+        }
+        
+        for (const auto& [name, value] : vnode.styles) {
+            dom_setStyleProperty(elementHandle, name.c_str(), value.c_str());
         }
+        countJsCalls(static_cast<uint32_t>(vnode.styles.size()));
         
         // Render and append children
         renderChildren(elementHandle, vnode.children);
@@ -116,24 +299,78 @@ EM_VAL renderVNode(const VNode& vnode) {
     return elementHandle;
 }
 
+// Clone a shape's template and patch in this instance's differences.
+// Returns 0 when the instance cannot be derived from the template.
+EM_VAL renderFromTemplate(const VNode& vnode) {
+    auto it = g_templatePrototypes.find(vnode.shape);
+    if (it == g_templatePrototypes.end()) {
+        return 0;
+    }
+    
+    DiffNode diff = diffNodes(it->second, vnode);
+    if (diff.op == DiffOp::REPLACE) {
+        // Root tag differs, nothing to reuse
+        return 0;
+    }
+    
+    EM_VAL clone = dom_cloneTemplate(static_cast<int>(vnode.shape));
+    frameStats().current().nodesCreated++;
+    countJsCalls();
+    patchNode(clone, diff);
+    return clone;
+}
+
+// Render a VNode to a DOM element
+EM_VAL renderVNode(const VNode& node) {
+    const VNode& vnode = node.resolved();
+    
+    if (vnode.shape == 0) {
+        return renderFresh(vnode);
+    }
+    
+    if (EM_VAL clone = renderFromTemplate(vnode)) {
+        return clone;
+    }
+    
+    EM_VAL elementHandle = renderFresh(vnode);
+    if (!g_templatePrototypes.count(vnode.shape)) {
+        // First instance of this shape becomes its template
+        dom_registerTemplate(static_cast<int>(vnode.shape), elementHandle);
+        countJsCalls();
+        VNode prototype = vnode;
+        prototype.makeOwned();
+        g_templatePrototypes.emplace(vnode.shape, std::move(prototype));
+    }
+    return elementHandle;
+}
+
 // ============================================================================
 // Patching - Apply DiffNode to existing DOM
 // ============================================================================
 
-// Forward declaration
-void patchNode(EM_VAL domElement, const DiffNode& diff);
-
 // Patch props on an element
 void patchProps(EM_VAL domElement, const PropDiff& propDiff) {
     // Add or update props
     for (const auto& [key, value] : propDiff.added) {
-        dom_setAttribute(domElement, key.c_str(), value.c_str());
+        setProp(domElement, key, value);
     }
     
     // Remove props
     for (const auto& key : propDiff.removed) {
-        dom_removeAttribute(domElement, key.c_str());
+        removeProp(domElement, key);
+    }
+}
+
+// Patch individual style properties on an element
+void patchStyle(EM_VAL domElement, const PropDiff& styleDiff) {
+    for (const auto& [name, value] : styleDiff.added) {
+        dom_setStyleProperty(domElement, name.c_str(), value.c_str());
+    }
+    
+    for (const auto& name : styleDiff.removed) {
+        dom_removeStyleProperty(domElement, name.c_str());
     }
+    countJsCalls(static_cast<uint32_t>(styleDiff.added.size() + styleDiff.removed.size()));
 }
 
 // Patch children recursively
@@ -144,6 +381,7 @@ void patchChildren(EM_VAL domElement,
     // 1. Patch existing children that have diffs
     for (const auto& [index, childDiff] : childrenDiff) {
         EM_VAL childElement = dom_getChildAt(domElement, index);
+        countJsCalls();
         if (childElement) {
             patchNode(childElement, childDiff);
             emscripten::internal::_emval_decref(childElement);
@@ -153,8 +391,11 @@ void patchChildren(EM_VAL domElement,
     // 2. Remove children (iterate backwards to maintain indices)
     for (auto it = removedIndices.rbegin(); it != removedIndices.rend(); ++it) {
         EM_VAL childToRemove = dom_getChildAt(domElement, *it);
+        countJsCalls();
         if (childToRemove) {
             dom_removeChild(domElement, childToRemove);
+            countJsCalls();
+            frameStats().current().nodesRemoved++;
             emscripten::internal::_emval_decref(childToRemove);
         }
     }
@@ -164,6 +405,7 @@ void patchChildren(EM_VAL domElement,
         EM_VAL newChildElement = renderVNode(newChild);
         if (newChildElement) {
             dom_appendChild(domElement, newChildElement);
+            countJsCalls();
             emscripten::internal::_emval_decref(newChildElement);
         }
     }
@@ -189,6 +431,8 @@ void patchNode(EM_VAL domElement, const DiffNode& diff) {
                 EM_VAL parentHandle = parent.as_handle();
                 dom_replaceChild(parentHandle, newElement, domElement);
             }
+            countJsCalls(2);  // parentNode lookup and replaceChild
+            frameStats().current().nodesRemoved++;
             
             emscripten::internal::_emval_decref(newElement);
         }
@@ -201,6 +445,11 @@ void patchNode(EM_VAL domElement, const DiffNode& diff) {
             patchProps(domElement, *diff.propDiff);
         }
         
+        // Update changed style properties only
+        if (diff.hasStyleChanged() && diff.styleDiff) {
+            patchStyle(domElement, *diff.styleDiff);
+        }
+        
         // Update children if needed
         if (diff.hasChildrenChanged()) {
             patchChildren(
@@ -0,0 +1,262 @@
+#pragma once
+
+#include "VNode.hpp"
+#include "Diff.hpp"
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+// ============================================================================
+// PatchStream - Flat binary encoding of a DiffNode tree
+// ============================================================================
+// Lets a diff computed in one place (a worker thread, or a server) be handed
+// over as a single byte buffer and applied somewhere else with patch().
+// Pure C++: no DOM or emscripten dependency.
+//
+// Little-endian, depth-first:
+//   diff     := u8 op, [REPLACE: vnode] [UPDATE: u8 flags, props?, style?, children?]
+//   props    := u32 n, n * (str key, str value), u32 m, m * str key
+//   style    := same layout as props
+//   children := u32 n, n * (u32 index, diff), u32 a, a * vnode, u32 r, r * u32 index
+//   vnode    := u16 tag, u32 shape, TEXT: str text | map props, map styles,
+//               u32 c, c * vnode
+//   map      := u32 n, n * (str key, str value)
+//   str      := u32 length, bytes
+// Hoisted fragments are written out in full; the receiver owns every string.
+
+class PatchStreamWriter {
+public:
+    explicit PatchStreamWriter(std::vector<uint8_t>& out) : out(out) {}
+
+    void writeDiff(const DiffNode& diff) {
+        writeU8(static_cast<uint8_t>(diff.op));
+        if (diff.op == DiffOp::REPLACE) {
+            writeVNode(*diff.newNode);
+        } else if (diff.op == DiffOp::UPDATE) {
+            writeU8(diff.updateFlags);
+            if (diff.hasPropsChanged()) {
+                writePropDiff(*diff.propDiff);
+            }
+            if (diff.hasStyleChanged()) {
+                writePropDiff(*diff.styleDiff);
+            }
+            if (diff.hasChildrenChanged()) {
+                writeU32(static_cast<uint32_t>(diff.childrenDiff.size()));
+                for (const auto& [index, childDiff] : diff.childrenDiff) {
+                    writeU32(static_cast<uint32_t>(index));
+                    writeDiff(childDiff);
+                }
+                writeU32(static_cast<uint32_t>(diff.addedChildren.size()));
+                for (const auto& child : diff.addedChildren) {
+                    writeVNode(child);
+                }
+                writeU32(static_cast<uint32_t>(diff.removedChildIndices.size()));
+                for (size_t index : diff.removedChildIndices) {
+                    writeU32(static_cast<uint32_t>(index));
+                }
+            }
+        }
+    }
+
+    void writeVNode(const VNode& ref) {
+        const VNode& node = ref.resolved();
+        writeU16(static_cast<uint16_t>(node.tag));
+        writeU32(node.shape);
+        if (node.isText()) {
+            writeString(node.getText().view());
+            return;
+        }
+        writeMap(node.props);
+        writeMap(node.styles);
+        writeU32(static_cast<uint32_t>(node.children.size()));
+        for (const auto& child : node.children) {
+            writeVNode(child);
+        }
+    }
+
+private:
+    void writeMap(const Props& map) {
+        writeU32(static_cast<uint32_t>(map.size()));
+        for (const auto& [key, value] : map) {
+            writeString(key);
+            writeString(value.view());
+        }
+    }
+
+    void writePropDiff(const PropDiff& propDiff) {
+        writeMap(propDiff.added);
+        writeU32(static_cast<uint32_t>(propDiff.removed.size()));
+        for (const auto& key : propDiff.removed) {
+            writeString(key);
+        }
+    }
+
+    void writeU8(uint8_t v) {
+        out.push_back(v);
+    }
+
+    void writeU16(uint16_t v) {
+        out.push_back(static_cast<uint8_t>(v));
+        out.push_back(static_cast<uint8_t>(v >> 8));
+    }
+
+    void writeU32(uint32_t v) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            out.push_back(static_cast<uint8_t>(v >> shift));
+        }
+    }
+
+    void writeString(std::string_view s) {
+        writeU32(static_cast<uint32_t>(s.size()));
+        out.insert(out.end(), s.begin(), s.end());
+    }
+
+    std::vector<uint8_t>& out;
+};
+
+// Decodes a stream produced by PatchStreamWriter. Truncated or malformed
+// input sets failed() and yields empty nodes instead of reading past the end.
+class PatchStreamReader {
+public:
+    PatchStreamReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+    bool failed() const {
+        return error;
+    }
+
+    DiffNode readDiff() {
+        DiffNode diff;
+        uint8_t op = readU8();
+        if (op == static_cast<uint8_t>(DiffOp::REPLACE)) {
+            diff.op = DiffOp::REPLACE;
+            diff.newNode = readVNode();
+        } else if (op == static_cast<uint8_t>(DiffOp::UPDATE)) {
+            diff.op = DiffOp::UPDATE;
+            diff.updateFlags = readU8();
+            if (diff.updateFlags & UPDATE_PROPS) {
+                diff.propDiff = readPropDiff();
+            }
+            if (diff.updateFlags & UPDATE_STYLE) {
+                diff.styleDiff = readPropDiff();
+            }
+            if (diff.updateFlags & UPDATE_CHILDREN) {
+                for (uint32_t n = readCount(); n > 0; --n) {
+                    size_t index = readU32();
+                    diff.childrenDiff[index] = readDiff();
+                }
+                for (uint32_t n = readCount(); n > 0; --n) {
+                    diff.addedChildren.push_back(readVNode());
+                }
+                for (uint32_t n = readCount(); n > 0; --n) {
+                    diff.removedChildIndices.push_back(readU32());
+                }
+            }
+        }
+        return diff;
+    }
+
+    VNode readVNode() {
+        uint16_t tagValue = readU16();
+        VNode node(tagValue < kTagCount ? static_cast<Tag>(tagValue) : Tag::DIV);
+        node.shape = readU32();
+        if (node.isText()) {
+            node.props.emplace("text", readString());
+            node.rehash();
+            return node;
+        }
+        readMap(node.props);
+        readMap(node.styles);
+        for (uint32_t n = readCount(); n > 0; --n) {
+            node.children.push_back(readVNode());
+        }
+        node.rehash();
+        return node;
+    }
+
+private:
+    void readMap(Props& map) {
+        for (uint32_t n = readCount(); n > 0; --n) {
+            std::string key = readString();
+            map[std::move(key)] = PropValue(readString());
+        }
+    }
+
+    PropDiff readPropDiff() {
+        PropDiff propDiff;
+        readMap(propDiff.added);
+        for (uint32_t n = readCount(); n > 0; --n) {
+            propDiff.removed.push_back(readString());
+        }
+        return propDiff;
+    }
+
+    bool take(size_t count) {
+        if (error || size - pos < count) {
+            error = true;
+            return false;
+        }
+        return true;
+    }
+
+    uint8_t readU8() {
+        if (!take(1)) {
+            return 0;
+        }
+        return data[pos++];
+    }
+
+    uint16_t readU16() {
+        if (!take(2)) {
+            return 0;
+        }
+        uint16_t v = static_cast<uint16_t>(data[pos] | (data[pos + 1] << 8));
+        pos += 2;
+        return v;
+    }
+
+    uint32_t readU32() {
+        if (!take(4)) {
+            return 0;
+        }
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i) {
+            v |= static_cast<uint32_t>(data[pos + i]) << (8 * i);
+        }
+        pos += 4;
+        return v;
+    }
+
+    // Element counts can never exceed the remaining bytes; capping them
+    // keeps a corrupt count from driving a huge loop
+    uint32_t readCount() {
+        uint32_t n = readU32();
+        return n <= size - pos ? n : (error = true, 0);
+    }
+
+    std::string readString() {
+        uint32_t length = readU32();
+        if (!take(length)) {
+            return std::string();
+        }
+        std::string s(reinterpret_cast<const char*>(data + pos), length);
+        pos += length;
+        return s;
+    }
+
+    const uint8_t* data;
+    size_t size;
+    size_t pos = 0;
+    bool error = false;
+};
+
+inline void encodePatchStream(const DiffNode& diff, std::vector<uint8_t>& out) {
+    PatchStreamWriter(out).writeDiff(diff);
+}
+
+// Returns false if the stream was malformed; `out` is then unusable
+inline bool decodePatchStream(const uint8_t* data, size_t size, DiffNode& out) {
+    PatchStreamReader reader(data, size);
+    out = reader.readDiff();
+    return !reader.failed();
+}
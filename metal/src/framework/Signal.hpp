@@ -0,0 +1,191 @@
+#pragma once
+
+#include "SmallFunction.hpp"
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// ============================================================================
+// Signals - Reactive state with automatic dependency tracking
+// ============================================================================
+// A Signal holds a value. A Dependent (a component, or a Computed) that reads
+// signals inside a TrackingScope is subscribed to exactly those signals, and
+// a write to one of them calls markDirty() on its subscribers only.
+// Subscriptions are rebuilt on every tracked run, so branches that stop
+// reading a signal also stop depending on it.
+//
+// Main thread only, like render().
+
+class Dependent;
+
+class SignalBase {
+public:
+    SignalBase() = default;
+    SignalBase(const SignalBase&) = delete;
+    SignalBase& operator=(const SignalBase&) = delete;
+    virtual ~SignalBase();
+
+protected:
+    // Subscribe whoever is currently tracking to this signal
+    void track();
+
+    // Tell every subscriber that this signal changed
+    void notify();
+
+private:
+    friend class Dependent;
+    std::vector<Dependent*> dependents;
+};
+
+class Dependent {
+public:
+    Dependent() = default;
+    Dependent(const Dependent&) = delete;
+    Dependent& operator=(const Dependent&) = delete;
+
+    virtual ~Dependent() {
+        untrackAll();
+    }
+
+    // A signal read by the last tracked run has changed
+    virtual void markDirty() = 0;
+
+    // Whoever is reading signals right now, or nullptr
+    static Dependent*& current() {
+        static Dependent* dependent = nullptr;
+        return dependent;
+    }
+
+protected:
+    // Drop every subscription; done before each tracked run
+    void untrackAll() {
+        for (SignalBase* source : sources) {
+            auto& list = source->dependents;
+            list.erase(std::remove(list.begin(), list.end(), this), list.end());
+        }
+        sources.clear();
+    }
+
+private:
+    friend class SignalBase;
+    std::vector<SignalBase*> sources;
+};
+
+// Makes `dependent` the current tracker for the lifetime of the scope.
+// Scopes nest: a child component rendering inside its parent's render()
+// tracks its own reads, then the parent's tracking resumes.
+class TrackingScope {
+public:
+    explicit TrackingScope(Dependent* dependent) : previous(Dependent::current()) {
+        Dependent::current() = dependent;
+    }
+
+    ~TrackingScope() {
+        Dependent::current() = previous;
+    }
+
+    TrackingScope(const TrackingScope&) = delete;
+    TrackingScope& operator=(const TrackingScope&) = delete;
+
+private:
+    Dependent* previous;
+};
+
+inline SignalBase::~SignalBase() {
+    for (Dependent* dependent : dependents) {
+        auto& list = dependent->sources;
+        list.erase(std::remove(list.begin(), list.end(), this), list.end());
+    }
+}
+
+inline void SignalBase::track() {
+    Dependent* dependent = Dependent::current();
+    if (!dependent) {
+        return;
+    }
+    if (std::find(dependents.begin(), dependents.end(), dependent) == dependents.end()) {
+        dependents.push_back(dependent);
+        dependent->sources.push_back(this);
+    }
+}
+
+inline void SignalBase::notify() {
+    for (size_t i = 0; i < dependents.size(); ++i) {
+        dependents[i]->markDirty();
+    }
+}
+
+// ============================================================================
+// Signal - Writable state cell
+// ============================================================================
+template <typename T>
+class Signal : public SignalBase {
+public:
+    explicit Signal(T initial = T()) : value(std::move(initial)) {}
+
+    // Read and subscribe the current tracker
+    const T& get() const {
+        const_cast<Signal*>(this)->track();
+        return value;
+    }
+
+    // Read without subscribing (event handlers, logging)
+    const T& peek() const {
+        return value;
+    }
+
+    // Writing an equal value notifies nobody
+    void set(T newValue) {
+        if (value == newValue) {
+            return;
+        }
+        value = std::move(newValue);
+        notify();
+    }
+
+    // Modify in place and notify unconditionally
+    template <typename F>
+    void update(F&& modify) {
+        modify(value);
+        notify();
+    }
+
+private:
+    T value;
+};
+
+// ============================================================================
+// Computed - Memoized value derived from other signals
+// ============================================================================
+// Recomputed lazily: a change to one of its inputs only marks it (and,
+// transitively, its readers) dirty; the function runs again on the next get().
+template <typename T>
+class Computed : public SignalBase, public Dependent {
+public:
+    explicit Computed(SmallFunction<T()> compute) : compute(std::move(compute)) {}
+
+    const T& get() const {
+        auto* self = const_cast<Computed*>(this);
+        self->track();
+        if (self->dirty) {
+            self->untrackAll();
+            TrackingScope scope(self);
+            self->value = compute();
+            self->dirty = false;
+        }
+        return *value;
+    }
+
+    void markDirty() override {
+        if (!dirty) {
+            dirty = true;
+            notify();
+        }
+    }
+
+private:
+    SmallFunction<T()> compute;
+    std::optional<T> value;
+    bool dirty = true;
+};
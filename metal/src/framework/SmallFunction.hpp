@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// ============================================================================
+// SmallFunction - Move-only callable with inline storage
+// ============================================================================
+// Like std::function, but callables up to `Capacity` bytes (a lambda that
+// captures `this` and a couple of values) live inside the object and never
+// touch the heap. Larger ones fall back to a heap allocation.
+//
+// Trivially copyable callables can also be compared: sameAs() is true when
+// both hold the same callable type with bitwise-equal captures, which means
+// calling either does exactly the same thing.
+template <typename Signature, size_t Capacity = 3 * sizeof(void*)>
+class SmallFunction;
+
+template <typename R, typename... Args, size_t Capacity>
+class SmallFunction<R(Args...), Capacity> {
+public:
+    SmallFunction() = default;
+
+    template <typename F, typename = std::enable_if_t<
+        !std::is_same_v<std::decay_t<F>, SmallFunction>>>
+    SmallFunction(F&& callable) {
+        using Callable = std::decay_t<F>;
+        if constexpr (fitsInline<Callable>()) {
+            new (storage) Callable(std::forward<F>(callable));
+            ops = &inlineOps<Callable>;
+        } else {
+            *reinterpret_cast<Callable**>(storage) = new Callable(std::forward<F>(callable));
+            ops = &heapOps<Callable>;
+        }
+    }
+
+    SmallFunction(SmallFunction&& other) noexcept {
+        moveFrom(other);
+    }
+
+    SmallFunction& operator=(SmallFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    SmallFunction(const SmallFunction&) = delete;
+    SmallFunction& operator=(const SmallFunction&) = delete;
+
+    ~SmallFunction() {
+        reset();
+    }
+
+    explicit operator bool() const {
+        return ops != nullptr;
+    }
+
+    R operator()(Args... args) const {
+        return ops->invoke(const_cast<unsigned char*>(storage), std::forward<Args>(args)...);
+    }
+
+    void reset() {
+        if (ops) {
+            ops->destroy(storage);
+            ops = nullptr;
+        }
+    }
+
+    // Whether sameAs() and stateHash() can say anything about this callable
+    bool comparable() const {
+        return ops && ops->comparable;
+    }
+
+    bool sameAs(const SmallFunction& other) const {
+        return comparable() && ops == other.ops &&
+               std::memcmp(ops->target(storage), other.ops->target(other.storage), ops->size) == 0;
+    }
+
+    // Hash of the callable type and captured bytes, for comparable callables
+    size_t stateHash() const {
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](const unsigned char* bytes, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                hash = (hash ^ bytes[i]) * 1099511628211ull;
+            }
+        };
+        const void* type = ops;
+        mix(reinterpret_cast<const unsigned char*>(&type), sizeof(type));
+        if (comparable()) {
+            mix(static_cast<const unsigned char*>(ops->target(storage)), ops->size);
+        }
+        return static_cast<size_t>(hash);
+    }
+
+private:
+    struct Ops {
+        R (*invoke)(void* storage, Args&&... args);
+        void (*move)(void* to, void* from);
+        void (*destroy)(void* storage);
+        const void* (*target)(const void* storage);
+        size_t size;        // Bytes compared by sameAs()
+        bool comparable;
+    };
+
+    template <typename Callable>
+    static constexpr bool fitsInline() {
+        return sizeof(Callable) <= Capacity &&
+               alignof(Callable) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible_v<Callable>;
+    }
+
+    // Empty callables (captureless lambdas) are all equal and have no
+    // meaningful bytes to compare
+    template <typename Callable>
+    static constexpr size_t comparedSize() {
+        return std::is_empty_v<Callable> ? 0 : sizeof(Callable);
+    }
+
+    template <typename Callable>
+    static constexpr Ops inlineOps = {
+        [](void* storage, Args&&... args) -> R {
+            return (*static_cast<Callable*>(storage))(std::forward<Args>(args)...);
+        },
+        [](void* to, void* from) {
+            new (to) Callable(std::move(*static_cast<Callable*>(from)));
+            static_cast<Callable*>(from)->~Callable();
+        },
+        [](void* storage) {
+            static_cast<Callable*>(storage)->~Callable();
+        },
+        [](const void* storage) -> const void* {
+            return storage;
+        },
+        comparedSize<Callable>(),
+        std::is_trivially_copyable_v<Callable>
+    };
+
+    template <typename Callable>
+    static constexpr Ops heapOps = {
+        [](void* storage, Args&&... args) -> R {
+            return (**static_cast<Callable**>(storage))(std::forward<Args>(args)...);
+        },
+        [](void* to, void* from) {
+            *static_cast<Callable**>(to) = *static_cast<Callable**>(from);
+        },
+        [](void* storage) {
+            delete *static_cast<Callable**>(storage);
+        },
+        [](const void* storage) -> const void* {
+            return *static_cast<Callable* const*>(storage);
+        },
+        comparedSize<Callable>(),
+        std::is_trivially_copyable_v<Callable>
+    };
+
+    void moveFrom(SmallFunction& other) {
+        ops = other.ops;
+        if (ops) {
+            ops->move(storage, other.storage);
+            other.ops = nullptr;
+        }
+    }
+
+    static_assert(Capacity >= sizeof(void*), "SmallFunction needs room for a heap pointer");
+
+    alignas(std::max_align_t) unsigned char storage[Capacity];
+    const Ops* ops = nullptr;
+};
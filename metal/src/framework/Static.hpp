@@ -0,0 +1,48 @@
+#pragma once
+
+#include "VNode.hpp"
+#include <memory>
+#include <utility>
+
+// ============================================================================
+// StaticFragment - Constant subtree built once with stable identity
+// ============================================================================
+// ref() returns a lightweight VNode pointing at the shared subtree. Two refs
+// to the same fragment are skipped by the diff without descending, and the
+// subtree is never rebuilt or deep-copied per frame.
+//
+// Fragments must be fully constant: no event handlers (callback IDs are
+// per-frame) and nothing that depends on component state.
+class StaticFragment {
+public:
+    template <typename Builder>
+    explicit StaticFragment(Builder build)
+        : node(std::make_shared<const VNode>(owned(build()))) {}
+
+    VNode ref() const {
+        VNode handle(node->tag);
+        handle.fragment = node;
+        return handle;
+    }
+
+    const VNode& get() const {
+        return *node;
+    }
+
+private:
+    // The fragment outlives the frame arena its values were built in
+    static VNode owned(VNode vnode) {
+        vnode.makeOwned();
+        return vnode;
+    }
+
+    std::shared_ptr<const VNode> node;
+};
+
+// Hoist a constant subtree out of render(): the expression is evaluated on
+// first use only, and each call site gets its own fragment.
+//   h2({}, {text("Title")})  ->  HOIST(h2({}, {text("Title")}))
+#define HOIST(...) ([]() -> VNode { \
+    static const StaticFragment fragment([] { return __VA_ARGS__; }); \
+    return fragment.ref(); \
+}())
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <iostream>
+#include <string>
 #include <emscripten/val.h>
 #include <emscripten/emscripten.h>
 
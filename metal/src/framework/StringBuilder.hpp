@@ -0,0 +1,295 @@
+#pragma once
+
+#include "Arena.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// ============================================================================
+// FrameString - Non-owning, NUL-terminated view into frame arena memory
+// ============================================================================
+// Valid until the frame arena has been reset twice (see FrameArena). Never
+// store one in component state; store std::string there instead.
+struct FrameString {
+    const char* data = "";
+    size_t size = 0;
+
+    const char* c_str() const { return data; }
+    std::string_view view() const { return std::string_view(data, size); }
+};
+
+// ============================================================================
+// FrameStringBuilder - Appends into the current frame arena
+// ============================================================================
+class FrameStringBuilder {
+public:
+    explicit FrameStringBuilder(Arena& arena = frameArena().current())
+        : arena(arena) {}
+
+    FrameStringBuilder& append(std::string_view s) {
+        char* dst = reserve(s.size());
+        std::memcpy(dst, s.data(), s.size());
+        length += s.size();
+        return *this;
+    }
+
+    FrameStringBuilder& append(const char* s) {
+        return append(std::string_view(s));
+    }
+
+    FrameStringBuilder& append(const std::string& s) {
+        return append(std::string_view(s));
+    }
+
+    FrameStringBuilder& append(FrameString s) {
+        return append(s.view());
+    }
+
+    FrameStringBuilder& append(char c) {
+        *reserve(1) = c;
+        ++length;
+        return *this;
+    }
+
+    FrameStringBuilder& append(bool b) {
+        return append(b ? std::string_view("true") : std::string_view("false"));
+    }
+
+    template <typename T, typename std::enable_if<std::is_integral<T>::value &&
+                                                  !std::is_same<T, bool>::value &&
+                                                  !std::is_same<T, char>::value, int>::type = 0>
+    FrameStringBuilder& append(T n) {
+        if (std::is_signed<T>::value && n < 0) {
+            append('-');
+            // Negate in unsigned space so INT_MIN does not overflow
+            return appendUnsigned(0 - static_cast<uint64_t>(static_cast<int64_t>(n)));
+        }
+        return appendUnsigned(static_cast<uint64_t>(n));
+    }
+
+    // Fixed-point float formatting. A negative precision trims trailing zeros
+    // from a 6-digit fraction, which is what "{}" uses.
+    FrameStringBuilder& append(double v, int precision = -1) {
+        if (v != v) {
+            return append("NaN");
+        }
+        bool negative = v < 0;
+        if (negative) {
+            v = -v;
+        }
+        if (v > 1.7976931348623157e308) {
+            return append(negative ? "-Infinity" : "Infinity");
+        }
+        if (v >= 1e18) {
+            // Beyond uint64 range: print the leading digits and pad with zeros
+            int zeros = 0;
+            while (v >= 1e18) {
+                v /= 10;
+                ++zeros;
+            }
+            if (negative) {
+                append('-');
+            }
+            appendUnsigned(static_cast<uint64_t>(v));
+            while (zeros-- > 0) {
+                append('0');
+            }
+            return *this;
+        }
+
+        bool trim = precision < 0;
+        int digits = trim ? 6 : (precision > 9 ? 9 : precision);
+        uint64_t scale = 1;
+        for (int i = 0; i < digits; ++i) {
+            scale *= 10;
+        }
+
+        uint64_t whole = static_cast<uint64_t>(v);
+        uint64_t frac = static_cast<uint64_t>((v - static_cast<double>(whole)) * scale + 0.5);
+        if (frac >= scale) {
+            whole += 1;
+            frac -= scale;
+        }
+
+        // Skip the sign when the value rounds to zero
+        if (negative && (whole != 0 || frac != 0)) {
+            append('-');
+        }
+        appendUnsigned(whole);
+        if (digits == 0) {
+            return *this;
+        }
+
+        char buf[10];
+        for (int i = digits - 1; i >= 0; --i) {
+            buf[i] = static_cast<char>('0' + frac % 10);
+            frac /= 10;
+        }
+        int end = digits;
+        if (trim) {
+            while (end > 0 && buf[end - 1] == '0') {
+                --end;
+            }
+        }
+        if (end > 0) {
+            append('.');
+            append(std::string_view(buf, end));
+        }
+        return *this;
+    }
+
+    FrameStringBuilder& append(float v, int precision = -1) {
+        return append(static_cast<double>(v), precision);
+    }
+
+    template <typename T>
+    FrameStringBuilder& operator<<(const T& value) {
+        return append(value);
+    }
+
+    size_t size() const { return length; }
+
+    // Terminate and hand out the view. The builder may keep appending, but
+    // views handed out earlier keep their old length.
+    FrameString str() {
+        *reserve(1) = '\0';
+        return FrameString{buffer ? buffer : "", length};
+    }
+
+private:
+    FrameStringBuilder& appendUnsigned(uint64_t n) {
+        char buf[20];
+        int pos = 20;
+        do {
+            buf[--pos] = static_cast<char>('0' + n % 10);
+            n /= 10;
+        } while (n != 0);
+        return append(std::string_view(buf + pos, 20 - pos));
+    }
+
+    // Make room for `extra` bytes past the current length
+    char* reserve(size_t extra) {
+        size_t needed = length + extra;
+        if (needed > capacity) {
+            size_t newCapacity = capacity ? capacity * 2 : 32;
+            while (newCapacity < needed) {
+                newCapacity *= 2;
+            }
+            if (!buffer || !arena.tryExtend(buffer, capacity, newCapacity)) {
+                char* grown = static_cast<char*>(arena.allocate(newCapacity, 1));
+                if (length) {
+                    std::memcpy(grown, buffer, length);
+                }
+                buffer = grown;
+            }
+            capacity = newCapacity;
+        }
+        return buffer + length;
+    }
+
+    Arena& arena;
+    char* buffer = nullptr;
+    size_t length = 0;
+    size_t capacity = 0;
+};
+
+// ============================================================================
+// fmt - "{}" placeholder formatting into the frame arena
+// ============================================================================
+// fmt("Item #{} costs {:.2}", id, price)
+//   {}     next argument (floats: up to 6 decimals, trailing zeros trimmed)
+//   {:.N}  next argument, floats with exactly N decimals
+//   {{ }}  literal braces
+namespace detail {
+
+struct FormatArg {
+    enum Kind { SIGNED, UNSIGNED, FLOAT, STRING, BOOL, CHAR } kind;
+    union {
+        int64_t i;
+        uint64_t u;
+        double f;
+        bool b;
+        char c;
+    };
+    std::string_view s;
+
+    template <typename T, typename std::enable_if<std::is_integral<T>::value &&
+                                                  !std::is_same<T, bool>::value &&
+                                                  !std::is_same<T, char>::value, int>::type = 0>
+    FormatArg(T v) {
+        if (std::is_signed<T>::value) {
+            kind = SIGNED;
+            i = static_cast<int64_t>(v);
+        } else {
+            kind = UNSIGNED;
+            u = static_cast<uint64_t>(v);
+        }
+    }
+    FormatArg(bool v) : kind(BOOL), b(v) {}
+    FormatArg(char v) : kind(CHAR), c(v) {}
+    FormatArg(double v) : kind(FLOAT), f(v) {}
+    FormatArg(float v) : kind(FLOAT), f(v) {}
+    FormatArg(const char* v) : kind(STRING), u(0), s(v) {}
+    FormatArg(std::string_view v) : kind(STRING), u(0), s(v) {}
+    FormatArg(const std::string& v) : kind(STRING), u(0), s(v) {}
+    FormatArg(FrameString v) : kind(STRING), u(0), s(v.view()) {}
+
+    void appendTo(FrameStringBuilder& out, int precision) const {
+        switch (kind) {
+            case SIGNED: out.append(i); break;
+            case UNSIGNED: out.append(u); break;
+            case FLOAT: out.append(f, precision); break;
+            case STRING: out.append(s); break;
+            case BOOL: out.append(b); break;
+            case CHAR: out.append(c); break;
+        }
+    }
+};
+
+inline void formatInto(FrameStringBuilder& out, std::string_view pattern,
+                       const FormatArg* args, size_t argCount) {
+    size_t next = 0;
+    size_t i = 0;
+    while (i < pattern.size()) {
+        char c = pattern[i];
+        if (c == '{' && i + 1 < pattern.size() && pattern[i + 1] == '{') {
+            out.append('{');
+            i += 2;
+        } else if (c == '}' && i + 1 < pattern.size() && pattern[i + 1] == '}') {
+            out.append('}');
+            i += 2;
+        } else if (c == '{') {
+            size_t close = pattern.find('}', i);
+            if (close == std::string_view::npos) {
+                out.append(pattern.substr(i));
+                return;
+            }
+            int precision = -1;
+            std::string_view spec = pattern.substr(i + 1, close - i - 1);
+            if (spec.size() > 2 && spec[0] == ':' && spec[1] == '.') {
+                precision = 0;
+                for (size_t k = 2; k < spec.size() && spec[k] >= '0' && spec[k] <= '9'; ++k) {
+                    precision = precision * 10 + (spec[k] - '0');
+                }
+            }
+            if (next < argCount) {
+                args[next++].appendTo(out, precision);
+            }
+            i = close + 1;
+        } else {
+            out.append(c);
+            ++i;
+        }
+    }
+}
+
+} // namespace detail
+
+template <typename... Args>
+FrameString fmt(std::string_view pattern, const Args&... args) {
+    FrameStringBuilder out;
+    const detail::FormatArg argv[] = {detail::FormatArg(args)..., detail::FormatArg(0)};
+    detail::formatInto(out, pattern, argv, sizeof...(Args));
+    return out.str();
+}
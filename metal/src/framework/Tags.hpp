@@ -0,0 +1,308 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// ============================================================================
+// Tag and Attribute Tables
+// ============================================================================
+// Single source of truth for element and attribute names. The enums, the
+// constexpr name tables and the JS-side lookup arrays (see registerDomTables
+// in Patch.hpp) are all generated from these lists, so the DOM glue passes
+// small integers instead of decoding UTF-8 names on every call.
+//
+// The order of the first entries matches the original hand-written Tag enum;
+// append new entries at the end of a list.
+
+// ENTRY(ENUM_NAME, "tag-name")
+#define FRAMEWORK_HTML_TAGS(ENTRY) \
+    ENTRY(DIV, "div") ENTRY(SPAN, "span") \
+    ENTRY(H1, "h1") ENTRY(H2, "h2") ENTRY(H3, "h3") ENTRY(H4, "h4") ENTRY(H5, "h5") ENTRY(H6, "h6") \
+    ENTRY(P, "p") ENTRY(A, "a") ENTRY(BUTTON, "button") ENTRY(INPUT, "input") \
+    ENTRY(TEXTAREA, "textarea") ENTRY(SELECT, "select") ENTRY(OPTION, "option") \
+    ENTRY(UL, "ul") ENTRY(OL, "ol") ENTRY(LI, "li") \
+    ENTRY(TABLE, "table") ENTRY(THEAD, "thead") ENTRY(TBODY, "tbody") \
+    ENTRY(TR, "tr") ENTRY(TD, "td") ENTRY(TH, "th") \
+    ENTRY(FORM, "form") ENTRY(LABEL, "label") ENTRY(IMG, "img") ENTRY(BR, "br") ENTRY(HR, "hr") \
+    /* Document metadata */ \
+    ENTRY(HTML, "html") ENTRY(HEAD, "head") ENTRY(TITLE, "title") ENTRY(BASE, "base") \
+    ENTRY(LINK, "link") ENTRY(META, "meta") ENTRY(STYLE, "style") ENTRY(BODY, "body") \
+    /* Sections */ \
+    ENTRY(ARTICLE, "article") ENTRY(SECTION, "section") ENTRY(NAV, "nav") ENTRY(ASIDE, "aside") \
+    ENTRY(HGROUP, "hgroup") ENTRY(HEADER, "header") ENTRY(FOOTER, "footer") \
+    ENTRY(ADDRESS, "address") ENTRY(MAIN, "main") ENTRY(SEARCH, "search") \
+    /* Grouping */ \
+    ENTRY(PRE, "pre") ENTRY(BLOCKQUOTE, "blockquote") ENTRY(MENU, "menu") \
+    ENTRY(DL, "dl") ENTRY(DT, "dt") ENTRY(DD, "dd") ENTRY(FIGURE, "figure") \
+    ENTRY(FIGCAPTION, "figcaption") \
+    /* Text-level */ \
+    ENTRY(EM, "em") ENTRY(STRONG, "strong") ENTRY(SMALL, "small") ENTRY(S, "s") \
+    ENTRY(CITE, "cite") ENTRY(Q, "q") ENTRY(DFN, "dfn") ENTRY(ABBR, "abbr") \
+    ENTRY(RUBY, "ruby") ENTRY(RT, "rt") ENTRY(RP, "rp") ENTRY(DATA, "data") ENTRY(TIME, "time") \
+    ENTRY(CODE, "code") ENTRY(VAR, "var") ENTRY(SAMP, "samp") ENTRY(KBD, "kbd") \
+    ENTRY(SUB, "sub") ENTRY(SUP, "sup") ENTRY(I, "i") ENTRY(B, "b") ENTRY(U, "u") \
+    ENTRY(MARK, "mark") ENTRY(BDI, "bdi") ENTRY(BDO, "bdo") ENTRY(WBR, "wbr") \
+    ENTRY(INS, "ins") ENTRY(DEL, "del") \
+    /* Embedded content */ \
+    ENTRY(PICTURE, "picture") ENTRY(SOURCE, "source") ENTRY(IFRAME, "iframe") \
+    ENTRY(EMBED, "embed") ENTRY(OBJECT, "object") ENTRY(VIDEO, "video") \
+    ENTRY(AUDIO, "audio") ENTRY(TRACK, "track") ENTRY(MAP, "map") ENTRY(AREA, "area") \
+    ENTRY(CANVAS, "canvas") \
+    /* Tables */ \
+    ENTRY(CAPTION, "caption") ENTRY(COLGROUP, "colgroup") ENTRY(COL, "col") \
+    ENTRY(TFOOT, "tfoot") \
+    /* Forms */ \
+    ENTRY(DATALIST, "datalist") ENTRY(OPTGROUP, "optgroup") ENTRY(OUTPUT, "output") \
+    ENTRY(PROGRESS, "progress") ENTRY(METER, "meter") ENTRY(FIELDSET, "fieldset") \
+    ENTRY(LEGEND, "legend") \
+    /* Interactive */ \
+    ENTRY(DETAILS, "details") ENTRY(SUMMARY, "summary") ENTRY(DIALOG, "dialog") \
+    /* Scripting */ \
+    ENTRY(SCRIPT, "script") ENTRY(NOSCRIPT, "noscript") ENTRY(TEMPLATE, "template") \
+    ENTRY(SLOT, "slot")
+
+// Created with createElementNS(SVG namespace). Names that clash with HTML
+// elements (a, script, style, title) exist only through the SVG_ prefix.
+#define FRAMEWORK_SVG_TAGS(ENTRY) \
+    ENTRY(SVG, "svg") ENTRY(SVG_G, "g") ENTRY(SVG_DEFS, "defs") ENTRY(SVG_SYMBOL, "symbol") \
+    ENTRY(SVG_USE, "use") ENTRY(SVG_IMAGE, "image") ENTRY(SVG_SWITCH, "switch") \
+    ENTRY(SVG_A, "a") ENTRY(SVG_SCRIPT, "script") ENTRY(SVG_STYLE, "style") \
+    ENTRY(SVG_TITLE, "title") ENTRY(SVG_DESC, "desc") ENTRY(SVG_METADATA, "metadata") \
+    ENTRY(SVG_VIEW, "view") ENTRY(SVG_FOREIGN_OBJECT, "foreignObject") \
+    /* Shapes */ \
+    ENTRY(SVG_PATH, "path") ENTRY(SVG_RECT, "rect") ENTRY(SVG_CIRCLE, "circle") \
+    ENTRY(SVG_ELLIPSE, "ellipse") ENTRY(SVG_LINE, "line") ENTRY(SVG_POLYLINE, "polyline") \
+    ENTRY(SVG_POLYGON, "polygon") \
+    /* Text */ \
+    ENTRY(SVG_TEXT, "text") ENTRY(SVG_TSPAN, "tspan") ENTRY(SVG_TEXT_PATH, "textPath") \
+    /* Paint servers and masking */ \
+    ENTRY(SVG_MARKER, "marker") ENTRY(SVG_PATTERN, "pattern") \
+    ENTRY(SVG_CLIP_PATH, "clipPath") ENTRY(SVG_MASK, "mask") \
+    ENTRY(SVG_LINEAR_GRADIENT, "linearGradient") \
+    ENTRY(SVG_RADIAL_GRADIENT, "radialGradient") ENTRY(SVG_STOP, "stop") \
+    /* Filters */ \
+    ENTRY(SVG_FILTER, "filter") ENTRY(SVG_FE_BLEND, "feBlend") \
+    ENTRY(SVG_FE_COLOR_MATRIX, "feColorMatrix") \
+    ENTRY(SVG_FE_COMPONENT_TRANSFER, "feComponentTransfer") \
+    ENTRY(SVG_FE_COMPOSITE, "feComposite") \
+    ENTRY(SVG_FE_CONVOLVE_MATRIX, "feConvolveMatrix") \
+    ENTRY(SVG_FE_DIFFUSE_LIGHTING, "feDiffuseLighting") \
+    ENTRY(SVG_FE_DISPLACEMENT_MAP, "feDisplacementMap") \
+    ENTRY(SVG_FE_DISTANT_LIGHT, "feDistantLight") \
+    ENTRY(SVG_FE_DROP_SHADOW, "feDropShadow") ENTRY(SVG_FE_FLOOD, "feFlood") \
+    ENTRY(SVG_FE_FUNC_A, "feFuncA") ENTRY(SVG_FE_FUNC_B, "feFuncB") \
+    ENTRY(SVG_FE_FUNC_G, "feFuncG") ENTRY(SVG_FE_FUNC_R, "feFuncR") \
+    ENTRY(SVG_FE_GAUSSIAN_BLUR, "feGaussianBlur") ENTRY(SVG_FE_IMAGE, "feImage") \
+    ENTRY(SVG_FE_MERGE, "feMerge") ENTRY(SVG_FE_MERGE_NODE, "feMergeNode") \
+    ENTRY(SVG_FE_MORPHOLOGY, "feMorphology") ENTRY(SVG_FE_OFFSET, "feOffset") \
+    ENTRY(SVG_FE_POINT_LIGHT, "fePointLight") \
+    ENTRY(SVG_FE_SPECULAR_LIGHTING, "feSpecularLighting") \
+    ENTRY(SVG_FE_SPOT_LIGHT, "feSpotLight") ENTRY(SVG_FE_TILE, "feTile") \
+    ENTRY(SVG_FE_TURBULENCE, "feTurbulence") \
+    /* Animation */ \
+    ENTRY(SVG_ANIMATE, "animate") ENTRY(SVG_ANIMATE_MOTION, "animateMotion") \
+    ENTRY(SVG_ANIMATE_TRANSFORM, "animateTransform") ENTRY(SVG_MPATH, "mpath") \
+    ENTRY(SVG_SET, "set")
+
+// ENTRY(ENUM_NAME, "attribute-name")
+#define FRAMEWORK_ATTRIBUTES(ENTRY) \
+    /* Global */ \
+    ENTRY(ID, "id") ENTRY(CLASS, "class") ENTRY(STYLE, "style") ENTRY(TITLE, "title") \
+    ENTRY(LANG, "lang") ENTRY(DIR, "dir") ENTRY(HIDDEN, "hidden") ENTRY(TABINDEX, "tabindex") \
+    ENTRY(ACCESSKEY, "accesskey") ENTRY(DRAGGABLE, "draggable") \
+    ENTRY(CONTENTEDITABLE, "contenteditable") ENTRY(SPELLCHECK, "spellcheck") \
+    ENTRY(TRANSLATE, "translate") ENTRY(ROLE, "role") ENTRY(SLOT, "slot") \
+    /* Links and media */ \
+    ENTRY(HREF, "href") ENTRY(TARGET, "target") ENTRY(REL, "rel") ENTRY(DOWNLOAD, "download") \
+    ENTRY(HREFLANG, "hreflang") ENTRY(TYPE, "type") ENTRY(SRC, "src") ENTRY(SRCSET, "srcset") \
+    ENTRY(SIZES, "sizes") ENTRY(ALT, "alt") ENTRY(WIDTH, "width") ENTRY(HEIGHT, "height") \
+    ENTRY(LOADING, "loading") ENTRY(DECODING, "decoding") \
+    ENTRY(CROSSORIGIN, "crossorigin") ENTRY(REFERRERPOLICY, "referrerpolicy") \
+    ENTRY(CONTROLS, "controls") ENTRY(AUTOPLAY, "autoplay") ENTRY(LOOP, "loop") \
+    ENTRY(MUTED, "muted") ENTRY(POSTER, "poster") ENTRY(PRELOAD, "preload") \
+    ENTRY(PLAYSINLINE, "playsinline") ENTRY(MEDIA, "media") \
+    /* Forms */ \
+    ENTRY(NAME, "name") ENTRY(VALUE, "value") ENTRY(CHECKED, "checked") \
+    ENTRY(SELECTED, "selected") ENTRY(DISABLED, "disabled") ENTRY(READONLY, "readonly") \
+    ENTRY(REQUIRED, "required") ENTRY(MULTIPLE, "multiple") \
+    ENTRY(PLACEHOLDER, "placeholder") ENTRY(AUTOCOMPLETE, "autocomplete") \
+    ENTRY(AUTOFOCUS, "autofocus") ENTRY(MIN, "min") ENTRY(MAX, "max") ENTRY(STEP, "step") \
+    ENTRY(MINLENGTH, "minlength") ENTRY(MAXLENGTH, "maxlength") \
+    ENTRY(PATTERN, "pattern") ENTRY(SIZE, "size") ENTRY(FOR, "for") ENTRY(FORM, "form") \
+    ENTRY(ACTION, "action") ENTRY(METHOD, "method") ENTRY(ENCTYPE, "enctype") \
+    ENTRY(NOVALIDATE, "novalidate") ENTRY(ROWS, "rows") ENTRY(COLS, "cols") \
+    ENTRY(WRAP, "wrap") ENTRY(LABEL, "label") \
+    /* Tables and misc */ \
+    ENTRY(COLSPAN, "colspan") ENTRY(ROWSPAN, "rowspan") ENTRY(HEADERS, "headers") \
+    ENTRY(SCOPE, "scope") ENTRY(OPEN, "open") ENTRY(CONTENT, "content") \
+    ENTRY(CHARSET, "charset") ENTRY(HTTP_EQUIV, "http-equiv") ENTRY(ASYNC, "async") \
+    ENTRY(DEFER, "defer") ENTRY(INTEGRITY, "integrity") ENTRY(DATETIME, "datetime") \
+    ENTRY(CITE, "cite") ENTRY(START, "start") ENTRY(REVERSED, "reversed") \
+    /* Inline event handlers */ \
+    ENTRY(ONCLICK, "onclick") ENTRY(ONDBLCLICK, "ondblclick") ENTRY(ONINPUT, "oninput") \
+    ENTRY(ONCHANGE, "onchange") ENTRY(ONSUBMIT, "onsubmit") \
+    ENTRY(ONKEYDOWN, "onkeydown") ENTRY(ONKEYUP, "onkeyup") ENTRY(ONFOCUS, "onfocus") \
+    ENTRY(ONBLUR, "onblur") ENTRY(ONMOUSEENTER, "onmouseenter") \
+    ENTRY(ONMOUSELEAVE, "onmouseleave") \
+    /* SVG presentation and geometry */ \
+    ENTRY(XMLNS, "xmlns") ENTRY(VIEW_BOX, "viewBox") \
+    ENTRY(PRESERVE_ASPECT_RATIO, "preserveAspectRatio") ENTRY(D, "d") \
+    ENTRY(FILL, "fill") ENTRY(FILL_OPACITY, "fill-opacity") ENTRY(STROKE, "stroke") \
+    ENTRY(STROKE_WIDTH, "stroke-width") ENTRY(STROKE_OPACITY, "stroke-opacity") \
+    ENTRY(STROKE_LINECAP, "stroke-linecap") ENTRY(STROKE_LINEJOIN, "stroke-linejoin") \
+    ENTRY(STROKE_DASHARRAY, "stroke-dasharray") ENTRY(OPACITY, "opacity") \
+    ENTRY(TRANSFORM, "transform") ENTRY(CX, "cx") ENTRY(CY, "cy") ENTRY(R, "r") \
+    ENTRY(RX, "rx") ENTRY(RY, "ry") ENTRY(X, "x") ENTRY(Y, "y") ENTRY(X1, "x1") ENTRY(Y1, "y1") \
+    ENTRY(X2, "x2") ENTRY(Y2, "y2") ENTRY(POINTS, "points") ENTRY(OFFSET, "offset") \
+    ENTRY(STOP_COLOR, "stop-color") ENTRY(GRADIENT_UNITS, "gradientUnits") \
+    ENTRY(CLIP_PATH, "clip-path") ENTRY(MASK, "mask")
+
+// How the patcher applies an attribute. Anything not listed here is a plain
+// ATTRIBUTE. ENTRY(ENUM_NAME, KIND, "propertyName")
+#define FRAMEWORK_ATTRIBUTE_KINDS(ENTRY) \
+    /* Live state lives in the property; the attribute is only the default. */ \
+    /* (class stays an attribute: SVG className is a read-only object) */ \
+    ENTRY(VALUE, PROPERTY, "value") \
+    ENTRY(CHECKED, BOOLEAN_PROPERTY, "checked") ENTRY(SELECTED, BOOLEAN_PROPERTY, "selected") \
+    ENTRY(MUTED, BOOLEAN_PROPERTY, "muted") \
+    /* Presence means true */ \
+    ENTRY(HIDDEN, BOOLEAN, "hidden") ENTRY(DISABLED, BOOLEAN, "disabled") \
+    ENTRY(READONLY, BOOLEAN, "readOnly") ENTRY(REQUIRED, BOOLEAN, "required") \
+    ENTRY(MULTIPLE, BOOLEAN, "multiple") ENTRY(AUTOFOCUS, BOOLEAN, "autofocus") \
+    ENTRY(NOVALIDATE, BOOLEAN, "noValidate") ENTRY(CONTROLS, BOOLEAN, "controls") \
+    ENTRY(AUTOPLAY, BOOLEAN, "autoplay") ENTRY(LOOP, BOOLEAN, "loop") \
+    ENTRY(PLAYSINLINE, BOOLEAN, "playsInline") ENTRY(OPEN, BOOLEAN, "open") \
+    ENTRY(ASYNC, BOOLEAN, "async") ENTRY(DEFER, BOOLEAN, "defer") \
+    ENTRY(REVERSED, BOOLEAN, "reversed")
+
+// ============================================================================
+// Tag - Element enum
+// ============================================================================
+#define FRAMEWORK_ENUM_ENTRY(id, name) id,
+
+enum class Tag : uint16_t {
+    TEXT,       // Special tag for text nodes
+    FRAMEWORK_HTML_TAGS(FRAMEWORK_ENUM_ENTRY)
+    FRAMEWORK_SVG_TAGS(FRAMEWORK_ENUM_ENTRY)
+    COUNT
+};
+
+// Tags at or after this one are SVG elements
+constexpr Tag kFirstSvgTag = Tag::SVG;
+
+// ============================================================================
+// Attr - Known attribute enum
+// ============================================================================
+enum class Attr : uint16_t {
+    FRAMEWORK_ATTRIBUTES(FRAMEWORK_ENUM_ENTRY)
+    COUNT,
+    UNKNOWN = 0xFFFF    // Not in the table: set by name
+};
+
+#undef FRAMEWORK_ENUM_ENTRY
+
+// ============================================================================
+// Name Tables
+// ============================================================================
+#define FRAMEWORK_NAME_ENTRY(id, name) name,
+
+constexpr const char* kTagNames[] = {
+    "#text",
+    FRAMEWORK_HTML_TAGS(FRAMEWORK_NAME_ENTRY)
+    FRAMEWORK_SVG_TAGS(FRAMEWORK_NAME_ENTRY)
+};
+
+constexpr const char* kAttrNames[] = {
+    FRAMEWORK_ATTRIBUTES(FRAMEWORK_NAME_ENTRY)
+};
+
+#undef FRAMEWORK_NAME_ENTRY
+
+constexpr size_t kTagCount = static_cast<size_t>(Tag::COUNT);
+constexpr size_t kAttrCount = static_cast<size_t>(Attr::COUNT);
+
+static_assert(sizeof(kTagNames) / sizeof(kTagNames[0]) == kTagCount, "tag table out of sync");
+static_assert(sizeof(kAttrNames) / sizeof(kAttrNames[0]) == kAttrCount, "attribute table out of sync");
+
+// Helper to convert Tag enum to string
+constexpr const char* tagToString(Tag tag) {
+    return static_cast<size_t>(tag) < kTagCount ? kTagNames[static_cast<size_t>(tag)] : "div";
+}
+
+constexpr bool isSvgTag(Tag tag) {
+    return tag >= kFirstSvgTag && tag < Tag::COUNT;
+}
+
+constexpr const char* attrToString(Attr attr) {
+    return static_cast<size_t>(attr) < kAttrCount ? kAttrNames[static_cast<size_t>(attr)] : "";
+}
+
+// ============================================================================
+// AttrKind - Per-attribute dispatch table
+// ============================================================================
+enum class AttrKind : uint8_t {
+    ATTRIBUTE,          // setAttribute / removeAttribute
+    PROPERTY,           // element[property] = value / ""
+    BOOLEAN,            // toggleAttribute(name, value != "false")
+    BOOLEAN_PROPERTY    // element[property] = value != "false"
+};
+
+#define FRAMEWORK_KIND_ENTRY(id, kind, property) \
+    table[static_cast<size_t>(Attr::id)] = AttrKind::kind;
+
+constexpr std::array<AttrKind, kAttrCount> kAttrKinds = [] {
+    std::array<AttrKind, kAttrCount> table{};
+    FRAMEWORK_ATTRIBUTE_KINDS(FRAMEWORK_KIND_ENTRY)
+    return table;
+}();
+
+#undef FRAMEWORK_KIND_ENTRY
+
+// DOM property name for PROPERTY and BOOLEAN_PROPERTY kinds, "" otherwise
+#define FRAMEWORK_PROPERTY_ENTRY(id, kind, property) \
+    table[static_cast<size_t>(Attr::id)] = property;
+
+constexpr std::array<const char*, kAttrCount> kAttrPropertyNames = [] {
+    std::array<const char*, kAttrCount> table{};
+    for (auto& name : table) {
+        name = "";
+    }
+    FRAMEWORK_ATTRIBUTE_KINDS(FRAMEWORK_PROPERTY_ENTRY)
+    return table;
+}();
+
+#undef FRAMEWORK_PROPERTY_ENTRY
+
+constexpr AttrKind attrKind(Attr attr) {
+    return static_cast<size_t>(attr) < kAttrCount ? kAttrKinds[static_cast<size_t>(attr)]
+                                                  : AttrKind::ATTRIBUTE;
+}
+
+// ============================================================================
+// attrFromName - Prop key -> Attr lookup
+// ============================================================================
+// FNV-1a over the key, then one string compare to confirm. The switch cases
+// are generated from the table, so two attributes hashing to the same value
+// fail to compile instead of silently shadowing each other.
+constexpr uint32_t hashAttrName(std::string_view name) {
+    uint32_t hash = 2166136261u;
+    for (char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+inline Attr attrFromName(std::string_view name) {
+#define FRAMEWORK_ATTR_CASE(id, attrName) \
+    case hashAttrName(attrName): return name == attrName ? Attr::id : Attr::UNKNOWN;
+
+    switch (hashAttrName(name)) {
+        FRAMEWORK_ATTRIBUTES(FRAMEWORK_ATTR_CASE)
+        default: return Attr::UNKNOWN;
+    }
+
+#undef FRAMEWORK_ATTR_CASE
+}
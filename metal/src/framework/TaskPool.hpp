@@ -0,0 +1,200 @@
+#pragma once
+
+// ============================================================================
+// TaskPool - Work-stealing thread pool for the threaded build
+// ============================================================================
+// Each worker owns a deque: it pushes and pops its own tasks at the back and
+// steals from the front of the others when it runs dry. Threads outside the
+// pool submit through a shared queue. A thread waiting in parallelFor() keeps
+// running tasks instead of blocking, so nested parallelFor() calls (a task
+// that splits its own range) cannot deadlock.
+//
+// Only threads that are allowed to wait on others should use the pool. The
+// browser main thread must not, so it is never bound: see current().
+#ifdef FRAMEWORK_PTHREADS
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class TaskPool {
+public:
+    explicit TaskPool(unsigned threadCount) {
+        // Queue 0 is the shared submission queue, 1..n belong to the workers
+        for (unsigned i = 0; i <= threadCount; ++i) {
+            queues.push_back(std::make_unique<Queue>());
+        }
+        for (unsigned i = 1; i <= threadCount; ++i) {
+            threads.emplace_back([this, i]() { workerLoop(i); });
+        }
+    }
+
+    ~TaskPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        sleepCondition.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    size_t size() const {
+        return threads.size();
+    }
+
+    // Pool used by parallel code on this thread, or nullptr to stay serial
+    static TaskPool*& current() {
+        thread_local TaskPool* pool = nullptr;
+        return pool;
+    }
+
+    // Call body(begin, end) over [0, count) in chunks of at least `grain`
+    // items, and return once every chunk has run. The caller runs chunks too.
+    template <typename Body>
+    void parallelFor(size_t count, size_t grain, const Body& body) {
+        grain = std::max<size_t>(grain, 1);
+        size_t chunkCount = std::min((count + grain - 1) / grain, (size() + 1) * 4);
+        if (chunkCount <= 1 || size() == 0) {
+            body(size_t(0), count);
+            return;
+        }
+
+        size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+        std::atomic<size_t> remaining{chunkCount - 1};
+        size_t self = workerIndex();
+        for (size_t begin = chunkSize; begin < count; begin += chunkSize) {
+            size_t end = std::min(begin + chunkSize, count);
+            push(self, [&body, &remaining, begin, end]() {
+                body(begin, end);
+                remaining.fetch_sub(1, std::memory_order_release);
+            });
+        }
+
+        body(size_t(0), std::min(chunkSize, count));
+
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            if (!runOne(self)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    using Task = std::function<void()>;
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // 1..n on pool workers, 0 (the shared queue) everywhere else
+    static size_t& workerSlot() {
+        thread_local size_t slot = 0;
+        return slot;
+    }
+
+    size_t workerIndex() const {
+        return current() == this ? workerSlot() : 0;
+    }
+
+    void push(size_t index, Task task) {
+        queued.fetch_add(1, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(queues[index]->mutex);
+            queues[index]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        sleepCondition.notify_one();
+    }
+
+    bool popBack(size_t index, Task& task) {
+        Queue& queue = *queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    bool popFront(size_t index, Task& task) {
+        Queue& queue = *queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        return true;
+    }
+
+    // Own tasks newest first, then the oldest (largest) ones from elsewhere
+    bool runOne(size_t self) {
+        Task task;
+        bool found = self != 0 && popBack(self, task);
+        for (size_t i = 0; !found && i < queues.size(); ++i) {
+            size_t victim = (self + i) % queues.size();
+            if (victim != self || self == 0) {
+                found = popFront(victim, task);
+            }
+        }
+        if (!found) {
+            return false;
+        }
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        task();
+        return true;
+    }
+
+    void workerLoop(size_t index) {
+        current() = this;
+        workerSlot() = index;
+        for (;;) {
+            if (runOne(index)) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepCondition.wait(lock, [this]() {
+                return stopping || queued.load(std::memory_order_acquire) > 0;
+            });
+            if (stopping) {
+                return;
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::atomic<size_t> queued{0};
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    bool stopping = false;
+    std::vector<std::thread> threads;  // Last: started once the rest exists
+};
+
+// Pool shared by off-main-thread work. Leaves one core for the main thread
+// and one for the DiffWorker; on machines with fewer it has no threads and
+// parallelFor() runs inline.
+inline TaskPool& sharedTaskPool() {
+    static TaskPool instance([]() {
+        unsigned cores = std::thread::hardware_concurrency();
+        return cores > 2 ? cores - 2 : 0u;
+    }());
+    return instance;
+}
+
+#endif // FRAMEWORK_PTHREADS
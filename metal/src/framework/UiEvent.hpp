@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ============================================================================
+// UiEvent - Client -> server frames of a server-driven view
+// ============================================================================
+// A server-driven view (connectServerView in framework.cpp, UiSession in
+// MetalServer) renders and diffs on the server and streams PatchStream
+// frames to the page. Events go back the other way, one binary WebSocket
+// message each, little-endian:
+//   event := u8 kind, u32 handler id, [INPUT: UTF-8 value to end of frame]
+// HELLO (id 0) is sent when the socket opens and asks for the full tree.
+// Elements opt in through data attributes holding a handler ID:
+//   data-sui-click  CLICK, from a delegated click listener
+//   data-sui-input  INPUT with the element's value, coalesced per frame
+enum class UiEventKind : uint8_t {
+    HELLO = 0,
+    CLICK = 1,
+    INPUT = 2
+};
+
+struct UiEvent {
+    UiEventKind kind = UiEventKind::HELLO;
+    uint32_t id = 0;
+    std::string value;  // INPUT only
+};
+
+constexpr size_t kUiEventHeaderSize = 5;
+
+// Returns false for a frame that is too short or of an unknown kind
+inline bool decodeUiEvent(const uint8_t* data, size_t size, UiEvent& out) {
+    if (size < kUiEventHeaderSize || data[0] > static_cast<uint8_t>(UiEventKind::INPUT)) {
+        return false;
+    }
+    out.kind = static_cast<UiEventKind>(data[0]);
+    out.id = 0;
+    for (int i = 0; i < 4; ++i) {
+        out.id |= static_cast<uint32_t>(data[1 + i]) << (8 * i);
+    }
+    out.value.assign(reinterpret_cast<const char*>(data + kUiEventHeaderSize), size - kUiEventHeaderSize);
+    return true;
+}
+
+// What the page sends, for native clients such as a load generator
+inline void encodeUiEvent(const UiEvent& event, std::string& out) {
+    out.clear();
+    out.push_back(static_cast<char>(event.kind));
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<char>((event.id >> shift) & 0xFF));
+    }
+    out += event.value;
+}
@@ -1,83 +1,100 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <map>
 #include <string>
 #include <memory>
+#include <string_view>
+// VNode, Diff and PatchStream also build natively (MetalServer diffs
+// server-driven views); String wraps a JS string and is browser-only
+#ifdef __EMSCRIPTEN__
 #include "String.hpp"
+#endif
+#include "StringBuilder.hpp"
+#include "Tags.hpp"
 
 // ============================================================================
-// HTML Tag Enum - For performance
+// PropValue - Prop value that either owns its string or views frame memory
 // ============================================================================
-enum class Tag {
-    TEXT,       // Special tag for text nodes
-    DIV,
-    SPAN,
-    H1,
-    H2,
-    H3,
-    H4,
-    H5,
-    H6,
-    P,
-    A,
-    BUTTON,
-    INPUT,
-    TEXTAREA,
-    SELECT,
-    OPTION,
-    UL,
-    OL,
-    LI,
-    TABLE,
-    THEAD,
-    TBODY,
-    TR,
-    TD,
-    TH,
-    FORM,
-    LABEL,
-    IMG,
-    BR,
-    HR,
-    // Add more as needed
+// Values built with fmt()/FrameStringBuilder are held as views, so render code
+// can produce attribute strings without a heap copy per prop.
+class PropValue {
+public:
+    PropValue() = default;
+    PropValue(std::string s) : owned(std::move(s)) {}
+    PropValue(const char* s) : owned(s) {}
+    PropValue(FrameString s) : viewData(s.data), viewSize(s.size) {}
+
+    const char* c_str() const {
+        return viewData ? viewData : owned.c_str();
+    }
+
+    std::string_view view() const {
+        return viewData ? std::string_view(viewData, viewSize) : std::string_view(owned);
+    }
+
+    std::string str() const {
+        return std::string(view());
+    }
+
+    // Copy viewed frame memory into owned storage, for values that must
+    // outlive the frame (e.g. hoisted static fragments)
+    void makeOwned() {
+        if (viewData) {
+            owned.assign(viewData, viewSize);
+            viewData = nullptr;
+            viewSize = 0;
+        }
+    }
+
+    bool operator==(const PropValue& other) const {
+        return view() == other.view();
+    }
+
+    bool operator!=(const PropValue& other) const {
+        return view() != other.view();
+    }
+
+private:
+    std::string owned;
+    const char* viewData = nullptr;
+    size_t viewSize = 0;
 };
 
-// Helper to convert Tag enum to string
-inline const char* tagToString(Tag tag) {
-    switch (tag) {
-        case Tag::TEXT: return "#text";
-        case Tag::DIV: return "div";
-        case Tag::SPAN: return "span";
-        case Tag::H1: return "h1";
-        case Tag::H2: return "h2";
-        case Tag::H3: return "h3";
-        case Tag::H4: return "h4";
-        case Tag::H5: return "h5";
-        case Tag::H6: return "h6";
-        case Tag::P: return "p";
-        case Tag::A: return "a";
-        case Tag::BUTTON: return "button";
-        case Tag::INPUT: return "input";
-        case Tag::TEXTAREA: return "textarea";
-        case Tag::SELECT: return "select";
-        case Tag::OPTION: return "option";
-        case Tag::UL: return "ul";
-        case Tag::OL: return "ol";
-        case Tag::LI: return "li";
-        case Tag::TABLE: return "table";
-        case Tag::THEAD: return "thead";
-        case Tag::TBODY: return "tbody";
-        case Tag::TR: return "tr";
-        case Tag::TD: return "td";
-        case Tag::TH: return "th";
-        case Tag::FORM: return "form";
-        case Tag::LABEL: return "label";
-        case Tag::IMG: return "img";
-        case Tag::BR: return "br";
-        case Tag::HR: return "hr";
-        default: return "div";
+using Props = std::map<std::string, PropValue>;
+
+// CSS property name (hyphenated, as for style.setProperty) -> value
+using Styles = std::map<std::string, PropValue>;
+
+// ============================================================================
+// Structural hashing - 64-bit FNV-1a, folded bottom-up as nodes are built
+// ============================================================================
+constexpr uint64_t kHashSeed = 14695981039346656037ull;
+
+inline uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
     }
+    return hash;
+}
+
+// Length first, so "ab" + "c" and "a" + "bc" differ
+inline uint64_t hashString(uint64_t hash, std::string_view value) {
+    uint64_t size = value.size();
+    hash = hashBytes(hash, &size, sizeof(size));
+    return hashBytes(hash, value.data(), value.size());
+}
+
+inline uint64_t hashMap(uint64_t hash, const std::map<std::string, PropValue>& map) {
+    uint64_t count = map.size();
+    hash = hashBytes(hash, &count, sizeof(count));
+    for (const auto& [key, value] : map) {
+        hash = hashString(hash, key);
+        hash = hashString(hash, value.view());
+    }
+    return hash;
 }
 
 // ============================================================================
@@ -86,27 +103,131 @@ inline const char* tagToString(Tag tag) {
 class VNode {
 public:
     Tag tag;
-    std::map<std::string, std::string> props;
+    Props props;
     std::vector<VNode> children;
 
+    // Inline style, diffed and applied per property. Use either this or a
+    // "style" string prop on a node, not both.
+    Styles styles;
+
+    // Set on nodes standing in for a hoisted StaticFragment (see Static.hpp).
+    // Such nodes carry only the tag; content lives in *fragment.
+    std::shared_ptr<const VNode> fragment;
+
+    // Non-zero when declared through a TemplateShape: instances are cloned
+    // from a <template> built from the first one, then patched
+    uint32_t shape = 0;
+
+    // Hash of tag, props, styles and the children's hashes. Children are
+    // built before their parent, so each node only hashes its own data.
+    // Code that edits props/styles/children after construction must call
+    // rehash() before the node is diffed.
+    uint64_t hash = 0;
+
     // Constructor for element nodes
-    VNode(Tag t, std::map<std::string, std::string> p = {}, std::vector<VNode> c = {})
-        : tag(t), props(std::move(p)), children(std::move(c)) {}
+    VNode(Tag t, Props p = {}, std::vector<VNode> c = {})
+        : tag(t), props(std::move(p)), children(std::move(c)) {
+        rehash();
+    }
+
+    // Attach a style map: div({...}, {...}).style({{"transform", ...}})
+    VNode style(Styles s) && {
+        styles = std::move(s);
+        rehash();
+        return std::move(*this);
+    }
+
+    VNode& style(Styles s) & {
+        styles = std::move(s);
+        rehash();
+        return *this;
+    }
+
+    void rehash() {
+        uint16_t tagValue = static_cast<uint16_t>(tag);
+        uint64_t h = hashBytes(kHashSeed, &tagValue, sizeof(tagValue));
+        h = hashMap(h, props);
+        h = hashMap(h, styles);
+        uint64_t count = children.size();
+        h = hashBytes(h, &count, sizeof(count));
+        for (const VNode& child : children) {
+            uint64_t childHash = child.subtreeHash();
+            h = hashBytes(h, &childHash, sizeof(childHash));
+        }
+        hash = h;
+    }
+
+    // Hash of the content this node stands for, fragments included
+    uint64_t subtreeHash() const {
+        return fragment ? fragment->hash : hash;
+    }
 
     // Check if this is a text node
     bool isText() const {
         return tag == Tag::TEXT;
     }
 
+    // Node whose props/children describe this subtree. Traversals must go
+    // through this instead of reading props/children directly.
+    const VNode& resolved() const {
+        return fragment ? *fragment : *this;
+    }
+
+    // Detach all fmt() views in this subtree from the frame arena, for nodes
+    // that are kept beyond the current frame
+    void makeOwned() {
+        for (auto& [key, value] : props) {
+            value.makeOwned();
+        }
+        for (auto& [key, value] : styles) {
+            value.makeOwned();
+        }
+        for (auto& child : children) {
+            child.makeOwned();
+        }
+    }
+
     // Get text content (only valid for TEXT nodes)
-    std::string getText() const {
-        if (isText() && props.count("text")) {
-            return props.at("text");
+    const PropValue& getText() const {
+        static const PropValue empty;
+        if (isText()) {
+            const Props& textProps = resolved().props;
+            auto it = textProps.find("text");
+            if (it != textProps.end()) {
+                return it->second;
+            }
         }
-        return "";
+        return empty;
     }
 };
 
+// ============================================================================
+// TemplateShape - Declares a repeated subtree shape
+// ============================================================================
+// Wrap each instance of a repeated row in the same shape object:
+//   static const TemplateShape rowShape;
+//   return rowShape(div({...}, {...}));
+// The first instance is rendered normally and becomes the <template>; later
+// instances are created with cloneNode(true) and only their differences
+// from that first instance are patched.
+class TemplateShape {
+public:
+    TemplateShape() : id(nextId()) {}
+
+    VNode operator()(VNode node) const {
+        node.shape = id;
+        return node;
+    }
+
+private:
+    static uint32_t nextId() {
+        static uint32_t counter = 0;
+        return ++counter;
+    }
+
+    uint32_t id;
+};
+
 // ============================================================================
 // Helper Functions - Create text nodes
 // ============================================================================
@@ -114,122 +235,133 @@ inline VNode text(const std::string& content) {
     return VNode(Tag::TEXT, {{"text", content}});
 }
 
+#ifdef __EMSCRIPTEN__
 inline VNode text(const String& content) {
     return VNode(Tag::TEXT, {{"text", content.std_str()}});
 }
+#endif
 
 inline VNode text(const char* content) {
     return VNode(Tag::TEXT, {{"text", content}});
 }
 
+inline VNode text(FrameString content) {
+    return VNode(Tag::TEXT, {{"text", content}});
+}
+
 // ============================================================================
 // HTML Element Helper Functions
 // ============================================================================
-inline VNode div(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+// Generic element, for any Tag without a dedicated helper (including SVG)
+inline VNode el(Tag tag, Props props = {}, std::vector<VNode> children = {}) {
+    return VNode(tag, std::move(props), std::move(children));
+}
+
+inline VNode div(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::DIV, std::move(props), std::move(children));
 }
 
-inline VNode span(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode span(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::SPAN, std::move(props), std::move(children));
 }
 
-inline VNode h1(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode h1(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::H1, std::move(props), std::move(children));
 }
 
-inline VNode h2(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode h2(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::H2, std::move(props), std::move(children));
 }
 
-inline VNode h3(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode h3(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::H3, std::move(props), std::move(children));
 }
 
-inline VNode h4(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode h4(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::H4, std::move(props), std::move(children));
 }
 
-inline VNode h5(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode h5(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::H5, std::move(props), std::move(children));
 }
 
-inline VNode h6(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode h6(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::H6, std::move(props), std::move(children));
 }
 
-inline VNode p(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode p(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::P, std::move(props), std::move(children));
 }
 
-inline VNode a(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode a(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::A, std::move(props), std::move(children));
 }
 
-inline VNode button(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode button(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::BUTTON, std::move(props), std::move(children));
 }
 
-inline VNode input(std::map<std::string, std::string> props = {}) {
+inline VNode input(Props props = {}) {
     return VNode(Tag::INPUT, std::move(props), {});
 }
 
-inline VNode textarea(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode textarea(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::TEXTAREA, std::move(props), std::move(children));
 }
 
-inline VNode select(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode select(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::SELECT, std::move(props), std::move(children));
 }
 
-inline VNode option(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode option(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::OPTION, std::move(props), std::move(children));
 }
 
-inline VNode ul(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode ul(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::UL, std::move(props), std::move(children));
 }
 
-inline VNode ol(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode ol(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::OL, std::move(props), std::move(children));
 }
 
-inline VNode li(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode li(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::LI, std::move(props), std::move(children));
 }
 
-inline VNode table(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode table(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::TABLE, std::move(props), std::move(children));
 }
 
-inline VNode thead(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode thead(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::THEAD, std::move(props), std::move(children));
 }
 
-inline VNode tbody(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode tbody(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::TBODY, std::move(props), std::move(children));
 }
 
-inline VNode tr(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode tr(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::TR, std::move(props), std::move(children));
 }
 
-inline VNode td(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode td(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::TD, std::move(props), std::move(children));
 }
 
-inline VNode th(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode th(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::TH, std::move(props), std::move(children));
 }
 
-inline VNode form(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode form(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::FORM, std::move(props), std::move(children));
 }
 
-inline VNode label(std::map<std::string, std::string> props = {}, std::vector<VNode> children = {}) {
+inline VNode label(Props props = {}, std::vector<VNode> children = {}) {
     return VNode(Tag::LABEL, std::move(props), std::move(children));
 }
 
-inline VNode img(std::map<std::string, std::string> props = {}) {
+inline VNode img(Props props = {}) {
     return VNode(Tag::IMG, std::move(props), {});
 }
 
@@ -237,6 +369,6 @@ inline VNode br() {
     return VNode(Tag::BR, {}, {});
 }
 
-inline VNode hr(std::map<std::string, std::string> props = {}) {
+inline VNode hr(Props props = {}) {
     return VNode(Tag::HR, std::move(props), {});
 }
@@ -4,6 +4,46 @@
 
 set -e
 
+# Options:
+#   --threads  Diff on a pthread worker, splitting wide child lists across a
+#              work-stealing pool (needs SharedArrayBuffer, so the page must be
+#              served with COOP/COEP headers; the Metal server does)
+#   --verify-hashes
+#              Check every subtree the diff skips on a structural hash match
+#              against a full comparison, and log collisions to the console
+#   --lean     Size-optimized runtime: -Oz with LTO, no filesystem, plain C
+#              exports instead of embind function bindings (lean-exports.js
+#              maps them to the usual Module names), and the producers
+#              section stripped. Fails if framework.wasm exceeds
+#              size-budget.txt.
+#   --record-budget
+#              With --lean: set size-budget.txt to the measured size plus
+#              headroom instead of checking against it
+THREAD_FLAGS=()
+DEBUG_FLAGS=()
+LEAN=0
+RECORD_BUDGET=()
+for arg in "$@"; do
+    case "$arg" in
+        --lean)
+            LEAN=1
+            ;;
+        --threads)
+            THREAD_FLAGS=(-pthread -s PTHREAD_POOL_SIZE=navigator.hardwareConcurrency -DFRAMEWORK_PTHREADS)
+            ;;
+        --record-budget)
+            RECORD_BUDGET=(--record-budget)
+            ;;
+        --verify-hashes)
+            DEBUG_FLAGS+=(-DFRAMEWORK_VERIFY_HASHES)
+            ;;
+        *)
+            echo "❌ Unknown option: $arg"
+            exit 1
+            ;;
+    esac
+done
+
 echo "🔨 Building C++ Framework (Naked Version)..."
 
 # Check if emcc is available
@@ -17,24 +57,71 @@ fi
 # Create output directory
 mkdir -p output
 
+if [ $LEAN -eq 1 ]; then
+    LEAN_EXPORTS=_fw_startApp,_fw_invokeEventCallback,_fw_invokeStringEventCallback
+    LEAN_EXPORTS=$LEAN_EXPORTS,_fw_onAnimationFrame,_fw_onIdleCallback
+    LEAN_EXPORTS=$LEAN_EXPORTS,_fw_getFrameStats,_fw_setPerformanceMarks
+    LEAN_EXPORTS=$LEAN_EXPORTS,_fw_connectServerView,_fw_onServerMessages
+    # emcc runs wasm-opt itself at -Oz; extra passes go through it too, so
+    # the symbol map it writes indexes the module that ships
+    OPT_FLAGS=(-Oz -flto -DFRAMEWORK_LEAN -s FILESYSTEM=0
+               -s BINARYEN_EXTRA_PASSES=--strip-producers
+               -s EXPORTED_FUNCTIONS=$LEAN_EXPORTS --post-js lean-exports.js)
+else
+    OPT_FLAGS=(-O3)
+fi
+
 # Compile with Emscripten
 echo "📦 Compiling framework.cpp to WebAssembly..."
 
+# embind stays linked in both builds: emscripten::val and Emval handles are
+# how the patcher and String talk to the DOM
 emcc framework.cpp \
     -o output/framework.js \
     -lembind \
     -std=c++17 \
-    -O3 \
+    "${OPT_FLAGS[@]}" \
+    --emit-symbol-map \
     -s WASM=1 \
     -s ALLOW_MEMORY_GROWTH=1 \
     -s MODULARIZE=1 \
     -s EXPORT_NAME="Module" \
     -s EXPORTED_RUNTIME_METHODS='["ccall","cwrap"]' \
+    "${THREAD_FLAGS[@]}" \
+    "${DEBUG_FLAGS[@]}" \
     --bind
 
-# Copy HTML file
-echo "📄 Copying index.html to output..."
-cp index.html output/
+# Size report, largest functions named through the symbol map
+echo "📊 Size report:"
+if [ $LEAN -eq 1 ]; then
+    python3 size-report.py output/framework.wasm \
+        --symbols output/framework.js.symbols --budget size-budget.txt \
+        "${RECORD_BUDGET[@]}"
+else
+    python3 size-report.py output/framework.wasm --symbols output/framework.js.symbols
+fi
+
+# Copy HTML file, stamped with the module's content hash (the loader's
+# cache key), and the loader itself
+echo "📄 Copying index.html, wasm-loader.js and asset-manifest.json to output..."
+if command -v sha256sum &> /dev/null; then
+    WASM_HASH=$(sha256sum output/framework.wasm | cut -c1-16)
+else
+    WASM_HASH=$(shasum -a 256 output/framework.wasm | cut -c1-16)
+fi
+sed "s/__WASM_HASH__/$WASM_HASH/" index.html > output/index.html
+
+# Build manifest: what the server preloads (Link headers) with the document.
+# The wasm URL matches the one wasm-loader.js fetches, hash included.
+cat > output/asset-manifest.json <<EOF
+{
+  "preload": [
+    {"href": "/framework.js", "as": "script"},
+    {"href": "/framework.wasm?v=$WASM_HASH", "as": "fetch", "type": "application/wasm"}
+  ]
+}
+EOF
+cp wasm-loader.js output/
 
 echo ""
 echo "✅ Build completed successfully!"
@@ -42,7 +129,12 @@ echo ""
 echo "📁 Output files:"
 echo "   - output/framework.js (JavaScript glue code)"
 echo "   - output/framework.wasm (WebAssembly binary)"
-echo "   - output/index.html (Demo page)"
+if [ ${#THREAD_FLAGS[@]} -gt 0 ]; then
+    echo "   - output/framework.worker.js (pthread worker, older Emscripten only)"
+fi
+echo "   - output/index.html (Demo page, module hash $WASM_HASH)"
+echo "   - output/wasm-loader.js (streaming loader with module cache)"
+echo "   - output/asset-manifest.json (assets the server preloads)"
 echo ""
 echo "🚀 To run:"
 echo "   cd output"
@@ -3,14 +3,22 @@
 #include <emscripten/val.h>
 #include <emscripten/html5.h>
 #include <string>
-#include <functional>
+#include <algorithm>
 #include <unordered_map>
 #include <memory>
 #include <optional>
 #include "String.hpp"
+#include "StringBuilder.hpp"
 #include "VNode.hpp"
+#include "Static.hpp"
+#include "CallbackRegistry.hpp"
+#include "Signal.hpp"
 #include "Diff.hpp"
 #include "Patch.hpp"
+#include "DiffWorker.hpp"
+#include "FrameStats.hpp"
+#include "PatchStream.hpp"
+#include "UiEvent.hpp"
 
 using namespace emscripten;
 
@@ -21,67 +29,283 @@ class Renderer;
 Renderer* g_renderer = nullptr;
 
 // ============================================================================
-// Event System - Frame-scoped callback registry
+// Event System - Persistent callback registry
 // ============================================================================
-using EventCallback = std::function<void()>;
-using StringEventCallback = std::function<void(const std::string&)>;
-    
-std::vector<EventCallback> g_eventCallbacks;  // Cleared each frame
-std::vector<StringEventCallback> g_stringEventCallbacks;  // For string events
+// Handlers keep their slot (and ID) for as long as renders keep producing an
+// identical handler, so a render of an unchanged UI neither allocates nor
+// changes a single onclick attribute. Slots the new tree no longer uses are
+// only freed when its patch is committed, so events fired while a diff is
+// still in progress resolve against the handlers that are in the DOM.
+using EventCallback = SmallFunction<void()>;
+using StringEventCallback = SmallFunction<void(const std::string&)>;
+
+CallbackRegistry<void()> g_eventCallbacks;
+CallbackRegistry<void(const std::string&)> g_stringEventCallbacks;  // For string events
+CallbackRegistry<void(double, double)> g_pairEventCallbacks;  // Coalesced pointer/scroll
+
+// A handler ID used by a component's render, and how to keep it alive when
+// that render's cached subtree is reused (see ComponentBase::renderCached)
+struct CallbackUse {
+  void (*mark)(int id);
+  int id;
+};
 
-// Register a callback for this frame and return its ID (vector index)
-int registerEventCallback(EventCallback callback) {
-  int id = g_eventCallbacks.size();
-  g_eventCallbacks.push_back(std::move(callback));
+// Collects the handlers of the component rendering right now, if any
+std::vector<CallbackUse>* g_callbackRecorder = nullptr;
+
+void markEventCallback(int id) { g_eventCallbacks.mark(id); }
+void markStringEventCallback(int id) { g_stringEventCallbacks.mark(id); }
+void markPairEventCallback(int id) { g_pairEventCallbacks.mark(id); }
+
+int recordCallback(void (*mark)(int id), int id) {
+  if (g_callbackRecorder) {
+    g_callbackRecorder->push_back({mark, id});
+  }
   return id;
 }
 
-// Register a string callback for this frame and return its ID
-int registerStringEventCallback(StringEventCallback callback) {
-  int id = g_stringEventCallbacks.size();
-  g_stringEventCallbacks.push_back(std::move(callback));
-  return id;
+// Register a callback for this render and return its ID
+template <typename F>
+int registerEventCallback(F&& callback) {
+  return recordCallback(markEventCallback, g_eventCallbacks.add(std::forward<F>(callback)));
+}
+
+// Register a string callback for this render and return its ID
+template <typename F>
+int registerStringEventCallback(F&& callback) {
+  return recordCallback(markStringEventCallback, g_stringEventCallbacks.add(std::forward<F>(callback)));
+}
+
+// Register a coalesced (double, double) callback and return its ID
+template <typename F>
+int registerPairEventCallback(F&& callback) {
+  return recordCallback(markPairEventCallback, g_pairEventCallbacks.add(std::forward<F>(callback)));
 }
 
 // Call a registered callback from JavaScript
 void invokeEventCallback(int id) {
-  if (id >= 0 && id < static_cast<int>(g_eventCallbacks.size())) {
-    g_eventCallbacks[id]();
-  }
+  g_eventCallbacks.invoke(id);
 }
 
 // Call a registered string callback with the string value
 void invokeStringEventCallback(int id, const std::string& value) {
-  if (id >= 0 && id < static_cast<int>(g_stringEventCallbacks.size())) {
-    g_stringEventCallbacks[id](value);
-  }
+  g_stringEventCallbacks.invoke(id, value);
+}
+
+// A render is starting; it re-marks the handlers it still uses
+void beginFrameCallbacks() {
+  g_eventCallbacks.beginFrame();
+  g_stringEventCallbacks.beginFrame();
+  g_pairEventCallbacks.beginFrame();
 }
 
-// Clear callbacks at the start of each frame
-void clearFrameCallbacks() {
-  g_eventCallbacks.clear();
-  g_stringEventCallbacks.clear();
+// The render's DOM is committed; free the handlers it no longer uses
+void commitFrameCallbacks() {
+  g_eventCallbacks.commit();
+  g_stringEventCallbacks.commit();
+  g_pairEventCallbacks.commit();
+}
+
+// ============================================================================
+// Coalesced Events - pointermove, scroll and input, once per frame
+// ============================================================================
+// High-frequency events never call into wasm directly. Passive delegated
+// listeners keep only the latest payload per handler ID, and the first event
+// after a dispatch requests an animation frame from JS. The frame callback is
+// the only wasm entry: at its start the renderer pulls every pending record,
+// runs the handlers, and then renders once.
+//
+// Elements opt in through data attributes holding a handler ID:
+//   data-onpointermove  FuncPointerMove: (clientX, clientY), nearest match
+//   data-onscroll       FuncScroll: (scrollTop, scrollLeft) of the element
+//   data-oninput        FuncInputEvent: the element's value
+
+// Request the renderer's animation frame. Shared by the renderer and the
+// coalesced listeners (through Module.fwRequestFrame), so a frame wanted by
+// both is requested, and enters wasm, once.
+EM_JS(void, js_requestFrame, (), {
+  if (!Module.fwRequestFrame) {
+    let pending = false;
+    Module.fwRequestFrame = () => {
+      if (!pending) {
+        pending = true;
+        requestAnimationFrame(() => {
+          pending = false;
+          Module.onAnimationFrame();
+        });
+      }
+    };
+  }
+  Module.fwRequestFrame();
+});
+
+// Installed from the first render, so the renderer has already requested a
+// frame and Module.fwRequestFrame exists
+EM_JS(void, dom_listenCoalescedEvents, (), {
+  Module.fwCoalescedPairs = new Map();
+  Module.fwCoalescedStrings = new Map();
+
+  const queue = (records, id, payload) => {
+    records.set(id, payload);
+    Module.fwRequestFrame();
+  };
+  const options = { capture: true, passive: true };
+
+  document.addEventListener("pointermove", (event) => {
+    const target = event.target.closest ? event.target.closest("[data-onpointermove]") : null;
+    if (target) {
+      queue(Module.fwCoalescedPairs, Number(target.dataset.onpointermove),
+            [event.clientX, event.clientY]);
+    }
+  }, options);
+
+  // scroll does not bubble, but a capture listener on document still sees it
+  document.addEventListener("scroll", (event) => {
+    const target = event.target;
+    if (target.dataset && target.dataset.onscroll !== undefined) {
+      queue(Module.fwCoalescedPairs, Number(target.dataset.onscroll),
+            [target.scrollTop, target.scrollLeft]);
+    }
+  }, options);
+
+  document.addEventListener("input", (event) => {
+    const target = event.target;
+    if (target.dataset && target.dataset.oninput !== undefined) {
+      queue(Module.fwCoalescedStrings, Number(target.dataset.oninput), target.value);
+    }
+  }, options);
+});
+
+// Move up to `capacity` (id, a, b) records into `out`; returns the count
+EM_JS(int, dom_takeCoalescedPairs, (double* out, int capacity), {
+  const records = Module.fwCoalescedPairs;
+  if (!records) {
+    return 0;  // Listeners not installed yet
+  }
+  let count = 0;
+  for (const [id, payload] of records) {
+    if (count === capacity) {
+      break;
+    }
+    const base = (out >> 3) + count * 3;
+    HEAPF64[base] = id;
+    HEAPF64[base + 1] = payload[0];
+    HEAPF64[base + 2] = payload[1];
+    records.delete(id);
+    count++;
+  }
+  return count;
+});
+
+// Array of [id, value] records, emptied as it is taken
+EM_JS(EM_VAL, dom_takeCoalescedStrings, (), {
+  const records = Array.from(Module.fwCoalescedStrings || []);
+  if (records.length) {
+    Module.fwCoalescedStrings.clear();
+  }
+  return Emval.toHandle(records);
+});
+
+// Run the handlers for every event queued since the last frame
+void dispatchCoalescedEvents() {
+  constexpr int kBatch = 64;
+  double records[kBatch * 3];
+  int count;
+  do {
+    count = dom_takeCoalescedPairs(records, kBatch);
+    for (int i = 0; i < count; ++i) {
+      g_pairEventCallbacks.invoke(static_cast<int>(records[i * 3]),
+                                  records[i * 3 + 1], records[i * 3 + 2]);
+    }
+  } while (count == kBatch);
+
+  val strings = val::take_ownership(dom_takeCoalescedStrings());
+  int stringCount = strings["length"].as<int>();
+  for (int i = 0; i < stringCount; ++i) {
+    val record = strings[i];
+    g_stringEventCallbacks.invoke(record[0].as<int>(), record[1].as<std::string>());
+  }
 }
 
 // ============================================================================
 // Base Classes
 // ============================================================================
 
+// Update priority lanes, most urgent first
+enum class Priority {
+  URGENT,       // Input echo, hover feedback: rendered and committed next frame
+  NORMAL,       // Default: time-sliced across frames
+  BACKGROUND    // Deferred to idle time (requestIdleCallback)
+};
+
 class IInvalidator {
 public:
-  virtual void invalidate() = 0;
+  virtual void invalidate(Priority priority = Priority::NORMAL) = 0;
 };
 
-class ComponentBase: public IInvalidator {
+// Components track the signals their render() reads. Writing one of them
+// (or calling invalidate()) marks the component and its ancestors dirty; a
+// clean component rendered through renderCached() hands back its previous
+// subtree as a fragment, which the diff skips without descending.
+class ComponentBase: public IInvalidator, public Dependent {
 private:
     IInvalidator* invalidator;
+    bool dirty = true;
+    std::shared_ptr<const VNode> cached;
+    std::vector<CallbackUse> callbackUses;  // Handlers inside `cached`
 public:
     ComponentBase(IInvalidator* invalidator) : invalidator(invalidator) {}
     
     virtual VNode render() = 0;
     
-    void invalidate() {
-        invalidator->invalidate();
+    void invalidate(Priority priority = Priority::NORMAL) {
+        dirty = true;
+        invalidator->invalidate(priority);
+    }
+
+    // A signal read by the last render changed
+    void markDirty() override {
+        invalidate();
+    }
+
+    // render() with dependency tracking, result not cached (the root)
+    VNode renderTracked() {
+        untrackAll();
+        TrackingScope scope(this);
+        dirty = false;
+        return render();
+    }
+
+    // Use in a parent's render() instead of render(): only re-renders when
+    // dirty. A re-render detaches its tree from the frame arena so it can be
+    // reused in later frames.
+    VNode renderCached() {
+        std::vector<CallbackUse>* parentRecorder = g_callbackRecorder;
+        if (dirty || !cached) {
+            callbackUses.clear();
+            g_callbackRecorder = &callbackUses;
+            VNode node = renderTracked();
+            g_callbackRecorder = parentRecorder;
+            if (node.fragment) {
+                cached = node.fragment;
+            } else {
+                node.makeOwned();
+                cached = std::make_shared<const VNode>(std::move(node));
+            }
+        } else {
+            // The reused subtree still refers to these handlers
+            for (const CallbackUse& use : callbackUses) {
+                use.mark(use.id);
+            }
+        }
+
+        if (parentRecorder) {
+            parentRecorder->insert(parentRecorder->end(), callbackUses.begin(), callbackUses.end());
+        }
+
+        VNode handle(cached->tag);
+        handle.fragment = cached;
+        return handle;
     }
 };
 
@@ -96,64 +320,263 @@ public:
 // ============================================================================
 // Renderer - Handles scheduling and DOM updates
 // ============================================================================
+// requestIdleCallback, falling back to a short timeout where unsupported.
+// The timeout option keeps background work from starving indefinitely.
+EM_JS(void, js_requestIdleCallback, (), {
+  const run = (deadline) => Module.onIdleCallback(deadline.timeRemaining());
+  if (typeof requestIdleCallback === "function") {
+    requestIdleCallback(run, { timeout: 500 });
+  } else {
+    setTimeout(() => run({ timeRemaining: () => 5 }), 1);
+  }
+});
+
+// Renderer phases on the browser's performance timeline (DevTools, and any
+// PerformanceObserver doing RUM). Off by default: see setPerformanceMarks.
+bool g_performanceMarks = false;
+
+EM_JS(void, js_performanceMeasure, (const char* name, double start, double end), {
+  if (typeof performance !== "undefined" && performance.measure) {
+    performance.measure(UTF8ToString(name), { start: start, end: end });
+  }
+});
+
+void setPerformanceMarks(bool enabled) {
+  g_performanceMarks = enabled;
+}
+
+// Add the time since `start` to a phase of the current FrameStats
+void measurePhase(const char* name, double start, double& total) {
+  double end = emscripten_get_now();
+  total += end - start;
+  if (g_performanceMarks) {
+    js_performanceMeasure(name, start, end);
+  }
+}
+
+// Reconciliation is time-sliced: render() runs in one go, then the diff runs
+// as a resumable DiffTask that yields once the frame budget is spent and
+// continues on the next frame. The DOM is only touched when the diff is
+// complete, so a half-applied update is never visible.
+//
+// Each update carries the most urgent Priority it was invalidated with:
+//   URGENT      abandons any less urgent diff in flight, then renders, diffs
+//               and commits within the next frame without yielding
+//   NORMAL      diffs within the per-frame budget
+//   BACKGROUND  renders and diffs in idle callbacks, commits on a frame
+//
+// In the threaded build (FRAMEWORK_PTHREADS) NORMAL and BACKGROUND diffs run
+// on a DiffWorker instead, and the finished patch stream is applied on the
+// first frame after it lands. render() stays on the main thread: component
+// state and String handles are only valid there. URGENT updates are still
+// diffed inline, which is cheaper than a round trip for a small change.
 class Renderer: public IInvalidator {
 private:
   AppBase* app = nullptr;
-  std::optional<VNode> oldVNode;
+  std::optional<VNode> oldVNode;       // Matches the committed DOM
+  std::optional<VNode> pendingVNode;   // Rendered, diff in progress
+  std::unique_ptr<DiffTask> diffTask;
+  Priority taskPriority = Priority::NORMAL;
   EM_VAL rootElement = 0;
   bool hasPatches = false;
+  Priority pendingPriority = Priority::BACKGROUND;
   bool frameRequested = false;
+  bool idleRequested = false;
+  double frameBudgetMs = 8.0;
+  bool workerBusy = false;     // Threaded build: worker is diffing pendingVNode
+  bool workerStale = false;    // Its result was abandoned and will be dropped
+#ifdef FRAMEWORK_PTHREADS
+  DiffWorker diffWorker;
+  std::vector<uint8_t> patchStream;
+#endif
 
-  // requestAnimationFrame callback
-  static bool onFrame(double timestamp, void* userData) {
-    auto* renderer = static_cast<Renderer*>(userData);
-    renderer->frameRequested = false;
+  void requestFrame() {
+    if (!frameRequested) {
+      js_requestFrame();
+      frameRequested = true;
+    }
+  }
 
-    if (renderer->hasPatches) {
-      renderer->applyPatches();
-      renderer->hasPatches = false;
+  void requestIdle() {
+    if (!idleRequested) {
+      js_requestIdleCallback();
+      idleRequested = true;
     }
-    
-    return false; // We don't loop on frames automatically
   }
 
   void applyPatches() {
-    // Clear callbacks from previous frame
-    clearFrameCallbacks();
+    double frameStart = emscripten_get_now();
+    FrameStats& stats = frameStats().current();
+    stats.timestamp = frameStart;
+
+#ifdef FRAMEWORK_PTHREADS
+    pollWorker();
+#endif
+
+    // An update in flight is finished before the next render starts;
+    // invalidations meanwhile are picked up right after it commits.
+    // Background updates are started from idle callbacks instead.
+    if (!diffTask && !workerBusy && hasPatches && pendingPriority != Priority::BACKGROUND) {
+      beginUpdate();
+    }
+
+    if (diffTask && !diffTask->done() && taskPriority != Priority::BACKGROUND) {
+      double budget = taskPriority == Priority::URGENT ? 0 : frameBudgetMs;
+      double diffStart = emscripten_get_now();
+      diffTask->run([&]() {
+        return budget > 0 && emscripten_get_now() - frameStart >= budget;
+      });
+      measurePhase("fw:diff", diffStart, stats.diffMs);
+    }
+
+    // DOM writes only happen here, inside the animation frame
+    if (diffTask && diffTask->done()) {
+      commitUpdate();
+    }
+
+    stats.nodesVisited += takeDiffVisits();
+    frameStats().commit();
+    schedule();
+  }
+
+  // Render a new tree and start diffing it against the committed one
+  void beginUpdate() {
+    taskPriority = pendingPriority;
+    hasPatches = false;
+    pendingPriority = Priority::BACKGROUND;
+
+    beginFrameCallbacks();
+
+    // Switch arena buffers; oldVNode still points into the other one
+    frameArena().beginFrame();
     
     // Generate new VNode tree (this will register new callbacks)
-    VNode newVNode = app->render();
+    double renderStart = emscripten_get_now();
+    VNode newVNode = app->renderTracked();
+    measurePhase("fw:render", renderStart, frameStats().current().renderMs);
 
-    if (!oldVNode) {
-      // First render - create initial DOM
-      val document = val::global("document");
-      val root = document.call<val>("getElementById", val("app-root"));
-      
-      if (!root.isNull() && !root.isUndefined()) {
-        // Clear existing content
-        root.set("innerHTML", val(""));
-        
-        // Render new VNode tree
-        rootElement = renderVNode(newVNode);
-        
-        // Append to root
-        EM_VAL rootHandle = root.as_handle();
-        dom_appendChild(rootHandle, rootElement);
-        
-        // Setup event listeners
-        setupEventListeners();
+    if (oldVNode) {
+      pendingVNode = std::move(newVNode);
+#ifdef FRAMEWORK_PTHREADS
+      if (taskPriority != Priority::URGENT) {
+        diffWorker.post(*oldVNode, *pendingVNode);
+        workerBusy = true;
+        return;
       }
+#endif
+      diffTask = std::make_unique<DiffTask>(*oldVNode, *pendingVNode);
+      return;
+    }
+
+    double patchStart = emscripten_get_now();
+    mountInitial(newVNode);
+    measurePhase("fw:patch", patchStart, frameStats().current().patchMs);
+    commitFrameCallbacks();
+    oldVNode = std::move(newVNode);
+  }
+
+  void commitUpdate() {
+    DiffNode diff = diffTask->takeResult();
+    diffTask.reset();
+    commitDiff(diff);
+  }
+
+  // Apply the finished diff to the DOM in one go
+  void commitDiff(const DiffNode& diff) {
+    if (diff.hasChanges()) {
+      double patchStart = emscripten_get_now();
+      patch(rootElement, diff);
+      measurePhase("fw:patch", patchStart, frameStats().current().patchMs);
+    }
+
+    commitFrameCallbacks();
+
+    // Store new VNode for next diff
+    oldVNode = std::move(pendingVNode);
+    pendingVNode.reset();
+  }
+
+#ifdef FRAMEWORK_PTHREADS
+  // Take the worker's patch stream if it has landed. Never blocks.
+  void pollWorker() {
+    if (!workerBusy || !diffWorker.poll(patchStream)) {
+      return;
+    }
+    workerBusy = false;
+
+    // Timed on the worker, so it is not on this thread's timeline
+    FrameStats& stats = frameStats().current();
+    stats.diffMs += diffWorker.lastDiffMs();
+    stats.nodesVisited += diffWorker.lastNodesVisited();
+
+    if (workerStale) {
+      workerStale = false;
+      pendingVNode.reset();
+      return;
+    }
+
+    DiffNode diff;
+    if (!decodePatchStream(patchStream.data(), patchStream.size(), diff)) {
+      diff = diffNodes(*oldVNode, *pendingVNode);
+    }
+    commitDiff(diff);
+  }
+#endif
+
+  // Drop an in-flight update; a fresh render will include its changes.
+  // A tree the worker is still reading stays alive until its result lands,
+  // and no new render starts before then.
+  void abandonUpdate() {
+    diffTask.reset();
+    if (workerBusy) {
+      workerStale = true;
     } else {
-      // Subsequent renders - diff and patch
-      DiffNode diff = diffNodes(*oldVNode, newVNode);
-      
-      if (diff.hasChanges()) {
-        patch(rootElement, diff);
+      pendingVNode.reset();
+    }
+    frameArena().abandonFrame();
+    hasPatches = true;
+    pendingPriority = std::min(pendingPriority, taskPriority);
+  }
+
+  // Request whichever callback the remaining work needs
+  void schedule() {
+    if (workerBusy) {
+      requestFrame();  // Poll for the worker's result
+    } else if (diffTask) {
+      if (diffTask->done() || taskPriority != Priority::BACKGROUND) {
+        requestFrame();
+      } else {
+        requestIdle();
+      }
+    } else if (hasPatches) {
+      if (pendingPriority == Priority::BACKGROUND) {
+        requestIdle();
+      } else {
+        requestFrame();
       }
     }
+  }
 
-    // Store new VNode for next diff
-    oldVNode = std::move(newVNode);
+  void mountInitial(const VNode& newVNode) {
+    // First render - create initial DOM
+    val document = val::global("document");
+    val root = document.call<val>("getElementById", val("app-root"));
+    
+    if (!root.isNull() && !root.isUndefined()) {
+      // Clear existing content
+      root.set("innerHTML", val(""));
+      
+      // Render new VNode tree
+      registerDomTables();
+      rootElement = renderVNode(newVNode);
+      
+      // Append to root
+      EM_VAL rootHandle = root.as_handle();
+      dom_appendChild(rootHandle, rootElement);
+      
+      // Setup event listeners
+      setupEventListeners();
+    }
   }
 
   void setupEventListeners() {
@@ -163,6 +586,7 @@ private:
       window.set("__eventHandlerSetup", true);
       window.set("invokeEventCallback", val::module_property("invokeEventCallback"));
       window.set("invokeStringEventCallback", val::module_property("invokeStringEventCallback"));
+      dom_listenCoalescedEvents();
     }
   }
 
@@ -171,13 +595,56 @@ public:
     this->app = a_app;
   }
 
-  virtual void invalidate() {
+  // Milliseconds of diffing per frame before yielding; <= 0 disables slicing
+  void setFrameBudget(double milliseconds) {
+    frameBudgetMs = milliseconds;
+  }
+
+  virtual void invalidate(Priority priority = Priority::NORMAL) {
     hasPatches = true;
+    pendingPriority = std::min(pendingPriority, priority);
 
-    if (!frameRequested) {
-      emscripten_request_animation_frame(onFrame, this);
-      frameRequested = true;
+    // A more urgent update supersedes a stale one still being diffed
+    bool inFlight = diffTask || (workerBusy && !workerStale);
+    if (inFlight && priority < taskPriority) {
+      abandonUpdate();
     }
+
+    schedule();
+  }
+
+  // requestIdleCallback: background render and diff within the idle period
+  void onIdle(double timeRemaining) {
+    idleRequested = false;
+    double idleStart = emscripten_get_now();
+    FrameStats& stats = frameStats().current();
+    stats.timestamp = idleStart;
+
+    if (!diffTask && !workerBusy && hasPatches && pendingPriority == Priority::BACKGROUND) {
+      beginUpdate();
+    }
+
+    if (diffTask && !diffTask->done() && taskPriority == Priority::BACKGROUND) {
+      double diffStart = emscripten_get_now();
+      diffTask->run([&]() {
+        return emscripten_get_now() - idleStart >= timeRemaining;
+      });
+      measurePhase("fw:diff", diffStart, stats.diffMs);
+    }
+
+    stats.nodesVisited += takeDiffVisits();
+    frameStats().commit();
+    schedule();
+  }
+
+  // requestAnimationFrame callback (js_requestFrame)
+  void onFrame() {
+    // Flagged as requested while the handlers run, so ones that invalidate
+    // are picked up by this frame instead of scheduling another one
+    frameRequested = true;
+    dispatchCoalescedEvents();
+    frameRequested = false;
+    applyPatches();
   }
 
   void start() {
@@ -185,37 +652,355 @@ public:
   }
 };
 
+// Called by the frame callback scheduled through js_requestFrame
+void onAnimationFrame() {
+  if (g_renderer) {
+    g_renderer->onFrame();
+  }
+}
+
+// Called by the idle callback scheduled through js_requestIdleCallback
+void onIdleCallback(double timeRemaining) {
+  if (g_renderer) {
+    g_renderer->onIdle(timeRemaining);
+  }
+}
+
+// Recorded frames newer than `afterFrame`, oldest first. Pass the last
+// frame number seen to poll without duplicates, or 0 for the whole ring.
+val getFrameStats(uint32_t afterFrame) {
+  const FrameStatsRing& ring = frameStats();
+  val result = val::array();
+  for (size_t i = 0; i < ring.size(); ++i) {
+    const FrameStats& stats = ring.at(i);
+    if (stats.frame <= afterFrame) {
+      continue;
+    }
+    val record = val::object();
+    record.set("frame", stats.frame);
+    record.set("timestamp", stats.timestamp);
+    record.set("renderMs", stats.renderMs);
+    record.set("diffMs", stats.diffMs);
+    record.set("patchMs", stats.patchMs);
+    record.set("nodesVisited", stats.nodesVisited);
+    record.set("nodesCreated", stats.nodesCreated);
+    record.set("nodesRemoved", stats.nodesRemoved);
+    record.set("jsCalls", stats.jsCalls);
+    result.call<void>("push", record);
+  }
+  return result;
+}
+
+// ============================================================================
+// Server-Driven View - Render a UI that lives in MetalServer
+// ============================================================================
+// The server keeps the component state, renders and diffs it natively and
+// pushes each difference as a PatchStream frame over a WebSocket; this side
+// only applies them with the usual patcher. Events go back as UiEvent frames
+// (UiEvent.hpp): clicks right away, input values coalesced to one per frame.
+// Frames that arrive together are applied in one animation frame.
+//
+// A frame that does not decode means this view no longer matches the
+// server's: the rest of the queue is dropped and a HELLO asks the server for
+// the whole tree again, which replaces the root when it arrives.
+//
+// Shapes in server trees share the template IDs of this page, so a page
+// shows either a server view or local components, not both.
+EM_JS(void, js_connectServerView, (const char* url), {
+  const socket = new WebSocket(UTF8ToString(url));
+  socket.binaryType = "arraybuffer";
+  Module.fwServerMessages = [];
+  const inputs = new Map();
+  const encoder = new TextEncoder();
+  let framePending = false;
+
+  const send = (kind, id, value) => {
+    if (socket.readyState !== WebSocket.OPEN) {
+      return;
+    }
+    const text = value === undefined ? new Uint8Array(0) : encoder.encode(value);
+    const frame = new Uint8Array(5 + text.length);
+    const view = new DataView(frame.buffer);
+    view.setUint8(0, kind);
+    view.setUint32(1, id, true);
+    frame.set(text, 5);
+    socket.send(frame);
+  };
+  const flush = () => {
+    framePending = false;
+    for (const [id, value] of inputs) {
+      send(2, id, value);
+    }
+    inputs.clear();
+    if (Module.fwServerMessages.length) {
+      Module.onServerMessages();
+    }
+  };
+  const requestFlush = () => {
+    if (!framePending) {
+      framePending = true;
+      requestAnimationFrame(flush);
+    }
+  };
+
+  Module.fwServerHello = () => send(0, 0);
+  socket.onopen = Module.fwServerHello;
+  socket.onmessage = (event) => {
+    Module.fwServerMessages.push(new Uint8Array(event.data));
+    requestFlush();
+  };
+  socket.onclose = (event) => console.warn("Server view closed", event.code, event.reason);
+
+  document.addEventListener("click", (event) => {
+    const target = event.target.closest ? event.target.closest("[data-sui-click]") : null;
+    if (target) {
+      send(1, Number(target.dataset.suiClick));
+    }
+  });
+  document.addEventListener("input", (event) => {
+    const target = event.target;
+    if (target.dataset && target.dataset.suiInput !== undefined) {
+      inputs.set(Number(target.dataset.suiInput), target.value);
+      requestFlush();
+    }
+  }, { capture: true, passive: true });
+});
+
+// Byte size of the oldest queued server frame, or -1 if there is none
+EM_JS(int, js_serverMessageSize, (), {
+  const queue = Module.fwServerMessages;
+  return queue && queue.length ? queue[0].length : -1;
+});
+
+// Copy the oldest queued server frame into `out` and drop it
+EM_JS(void, js_takeServerMessage, (uint8_t* out), {
+  HEAPU8.set(Module.fwServerMessages.shift(), out);
+});
+
+// Drop every queued server frame and ask for the whole tree again
+EM_JS(void, js_resyncServerView, (), {
+  Module.fwServerMessages.length = 0;
+  Module.fwServerHello();
+});
+
+class ServerView {
+private:
+  val container = val::null();
+  EM_VAL rootElement = 0;
+  std::vector<uint8_t> message;  // Reused; grows to the largest frame
+  bool resyncing = false;        // Waiting for the full tree after a HELLO
+
+  void apply(const DiffNode& diff) {
+    if (diff.op == DiffOp::REPLACE && diff.newNode) {
+      // First frame (or a new root tag): build the tree and swap it in
+      EM_VAL element = renderVNode(*diff.newNode);
+      if (rootElement) {
+        dom_replaceChild(container.as_handle(), element, rootElement);
+        emscripten::internal::_emval_decref(rootElement);
+      } else {
+        container.set("innerHTML", val(""));
+        dom_appendChild(container.as_handle(), element);
+      }
+      countJsCalls();
+      rootElement = element;
+    } else if (rootElement && diff.hasChanges()) {
+      patch(rootElement, diff);
+    }
+  }
+
+public:
+  void connect(const std::string& url) {
+    container = val::global("document").call<val>("getElementById", val("app-root"));
+    if (container.isNull() || container.isUndefined()) {
+      val::global("console").call<void>("error", val("Server view: no #app-root element"));
+      return;
+    }
+    registerDomTables();
+    js_connectServerView(url.c_str());
+  }
+
+  // Apply every frame queued since the last call, in arrival order
+  void onMessages() {
+    FrameStats& stats = frameStats().current();
+    stats.timestamp = emscripten_get_now();
+    double patchStart = stats.timestamp;
+
+    int size;
+    while ((size = js_serverMessageSize()) >= 0) {
+      message.resize(static_cast<size_t>(size));
+      js_takeServerMessage(message.data());
+      DiffNode diff;
+      if (!decodePatchStream(message.data(), message.size(), diff)) {
+        val::global("console").call<void>("error", val("Server view: malformed patch frame, resyncing"));
+        resyncing = true;
+        js_resyncServerView();
+        break;
+      }
+      // Answers to events sent before the HELLO still patch the old tree;
+      // skip them until the full tree comes back
+      if (resyncing && diff.op != DiffOp::REPLACE) {
+        continue;
+      }
+      resyncing = false;
+      apply(diff);
+    }
+
+    measurePhase("fw:patch", patchStart, stats.patchMs);
+    frameStats().commit();
+  }
+};
+
+ServerView* g_serverView = nullptr;
+
+// Show the server-driven view served at `url` (ws:// or wss://) in #app-root,
+// instead of starting the local App
+void connectServerView(const std::string& url) {
+  if (!g_serverView) {
+    g_serverView = new ServerView();
+    g_serverView->connect(url);
+  }
+}
+
+// Called once per animation frame in which server frames arrived
+void onServerMessages() {
+  if (g_serverView) {
+    g_serverView->onMessages();
+  }
+}
+
 
 // ============================================================================
 // Event Callback Helpers - Create event handler strings
 // ============================================================================
 
 // Generic callback with no event data
-inline std::string Func(EventCallback callback) {
-    int callbackId = registerEventCallback(callback);
-    return "invokeEventCallback(" + std::to_string(callbackId) + ")";
+// Keep the lambda's own type (not std::function) so an identical handler
+// from the previous render is recognized and keeps its ID
+template <typename F>
+inline FrameString Func(F&& callback) {
+    int callbackId = registerEventCallback(std::forward<F>(callback));
+    return fmt("invokeEventCallback({})", callbackId);
 }
 
 // Input change callback - receives the input's value
-inline std::string FuncInputChange(StringEventCallback callback) {
-    int callbackId = registerStringEventCallback(callback);
-    return "invokeStringEventCallback(" + std::to_string(callbackId) + ", this.value)";
+template <typename F>
+inline FrameString FuncInputChange(F&& callback) {
+    int callbackId = registerStringEventCallback(std::forward<F>(callback));
+    return fmt("invokeStringEventCallback({}, this.value)", callbackId);
 }
 
-// Future: Mouse event callback (placeholder for future implementation)
-// inline std::string FuncMouseEvent(int eventId) {
-//     return "invokeCallbackMouseEvent(" + std::to_string(eventId) + ")";
-// }
+// Coalesced pointermove: receives the latest (clientX, clientY) per frame.
+// Use as the data-onpointermove attribute.
+template <typename F>
+inline FrameString FuncPointerMove(F&& callback) {
+    return fmt("{}", registerPairEventCallback(std::forward<F>(callback)));
+}
+
+// Coalesced scroll: receives the latest (scrollTop, scrollLeft) per frame.
+// Use as the data-onscroll attribute of the scrolling element.
+template <typename F>
+inline FrameString FuncScroll(F&& callback) {
+    return fmt("{}", registerPairEventCallback(std::forward<F>(callback)));
+}
+
+// Coalesced input: receives the latest value per frame. Use as the
+// data-oninput attribute; FuncInputChange still handles every keystroke.
+template <typename F>
+inline FrameString FuncInputEvent(F&& callback) {
+    return fmt("{}", registerStringEventCallback(std::forward<F>(callback)));
+}
 
 // Future: Keyboard event callback (placeholder for future implementation)
 // inline std::string FuncKeyboardEvent(int eventId) {
 //     return "invokeCallbackKeyboardEvent(" + std::to_string(eventId) + ")";
 // }
 
-// Future: Input event callback (placeholder for future implementation)
-// inline std::string FuncInputEvent(int eventId) {
-//     return "invokeCallbackInputEvent(" + std::to_string(eventId) + ")";
-// }
+
+// ============================================================================
+// VirtualList - Windowed rendering for large collections
+// ============================================================================
+
+// Renders only the rows in view plus `overscan` rows on each side. Rows are
+// placed in a fixed pool of slots (index % poolSize) and positioned with
+// transforms, so scrolling by one row rewrites one slot and the DOM nodes of
+// the others are reused as-is. VNode count, DOM size and diff cost depend on
+// the viewport, not on itemCount. Scrolling is delivered as a coalesced
+// event, so a fling costs one handler call per frame.
+class VirtualList : public ComponentBase {
+public:
+  using RowRenderer = SmallFunction<VNode(size_t index)>;
+
+private:
+  size_t itemCount;
+  int rowHeight;
+  int viewportHeight;
+  int overscan;
+  RowRenderer renderRow;
+  size_t firstVisible = 0;
+
+  size_t poolSize() const {
+    size_t visible = static_cast<size_t>((viewportHeight + rowHeight - 1) / rowHeight) + 1;
+    return visible + 2 * static_cast<size_t>(overscan);
+  }
+
+public:
+  VirtualList(IInvalidator* invalidator, size_t itemCount, int rowHeight, int viewportHeight,
+              RowRenderer renderRow, int overscan = 4)
+    : ComponentBase(invalidator), itemCount(itemCount), rowHeight(rowHeight > 0 ? rowHeight : 1),
+      viewportHeight(viewportHeight), overscan(overscan), renderRow(std::move(renderRow)) {}
+
+  VirtualList(const VirtualList&) = delete;
+  VirtualList& operator=(const VirtualList&) = delete;
+
+  void setItemCount(size_t count) {
+    itemCount = count;
+    invalidate();
+  }
+
+  // Re-render only when the first visible row changes
+  void onScroll(double scrollTop) {
+    size_t first = scrollTop > 0 ? static_cast<size_t>(scrollTop) / static_cast<size_t>(rowHeight) : 0;
+    if (first != firstVisible) {
+      firstVisible = first;
+      invalidate();
+    }
+  }
+
+  virtual VNode render() {
+    size_t pool = poolSize();
+    size_t first = std::min(firstVisible, itemCount);
+    size_t begin = first > static_cast<size_t>(overscan) ? first - overscan : 0;
+    size_t end = std::min(itemCount, begin + pool);
+
+    // Unused slots stay as hidden placeholders so slot positions never shift.
+    // Styles are maps, so moving a slot only rewrites its transform.
+    size_t slotCount = std::min(itemCount, pool);
+    std::vector<VNode> slots(slotCount, div().style({{"display", "none"}}));
+    for (size_t index = begin; index < end; ++index) {
+      slots[index % slotCount] = div({}, {renderRow(index)}).style({
+          {"position", "absolute"},
+          {"left", "0"},
+          {"right", "0"},
+          {"height", fmt("{}px", rowHeight)},
+          {"transform", fmt("translateY({}px)", static_cast<uint64_t>(index) * rowHeight)}
+      });
+    }
+
+    return div({
+        {"data-onscroll", FuncScroll([this](double scrollTop, double) { onScroll(scrollTop); })}
+    }, {
+        div({}, std::move(slots)).style({
+            {"position", "relative"},
+            {"height", fmt("{}px", static_cast<uint64_t>(itemCount) * rowHeight)}
+        })
+    }).style({
+        {"position", "relative"},
+        {"overflow-y", "auto"},
+        {"height", fmt("{}px", viewportHeight)}
+    });
+  }
+};
+
 
 
 
@@ -229,14 +1014,40 @@ public:
     : ComponentBase(invalidator), itemId(id) {}
 
   virtual VNode render() {
-    return div({{"style", "border: 1px solid #ccc; padding: 10px; margin: 5px;"}}, {
-        p({}, {text("Component Instance #" + std::to_string(itemId))}),
+    // All instances share the div/p/button shape
+    static const TemplateShape cardShape;
+    return cardShape(div({{"style", "border: 1px solid #ccc; padding: 10px; margin: 5px;"}}, {
+        p({}, {text(fmt("Component Instance #{}", itemId))}),
         button({{"onclick", Func([this]() {
             val console = val::global("console");
             console.call<void>("log", val("Clicked item " + std::to_string(itemId)));
             invalidate();
-        })}}, {text("Click Me!")})
-    });
+        })}}, {HOIST(text("Click Me!"))})
+    }));
+  }
+};
+
+
+
+
+// Owns the pointer position, so pointer moves re-render this component and
+// the path above it while every sibling is reused from its cache
+class PointerTracker : public ComponentBase {
+private:
+  Signal<double> x;
+  Signal<double> y;
+
+public:
+  PointerTracker(IInvalidator* invalidator) : ComponentBase(invalidator) {}
+
+  virtual VNode render() {
+    return div({
+        {"style", "height: 60px; background: #eef; padding: 10px;"},
+        {"data-onpointermove", FuncPointerMove([this](double clientX, double clientY) {
+            x.set(clientX);
+            y.set(clientY);
+        })}
+    }, {text(fmt("Pointer: {}, {}", x.get(), y.get()))});
   }
 };
 
@@ -245,9 +1056,17 @@ public:
 
 class App : public AppBase {
 private:
-  // Simple state
-  int counter = 0;
-  String message{"Hello from C++ with String!"};
+  // State: writing a signal re-renders only what read it
+  Signal<int> counter{0};
+  Computed<int> doubled{[this]() { return counter.get() * 2; }};
+  Signal<String> message{String("Hello from C++ with String!")};
+  PointerTracker pointer{this};
+  MyComponent card1{this, 1};
+  MyComponent card2{this, 2};
+  MyComponent card3{this, 3};
+  VirtualList rows{this, 100000, 24, 240, [](size_t index) {
+    return text(fmt("Row #{}", index));
+  }};
 
 public:
   App(IInvalidator* invalidator) : AppBase(invalidator) {
@@ -259,29 +1078,31 @@ public:
   // Render returns VNode tree
   virtual VNode render() {   
     return div({{"style", "font-family: sans-serif; padding: 20px;"}}, {
-        h1({}, {text(message.std_str())}),
-        p({}, {text("Counter: " + std::to_string(counter))}),
+        h1({}, {text(message.get().std_str())}),
+        p({}, {text(fmt("Counter: {} (doubled: {})", counter.get(), doubled.get()))}),
         button({{"onclick", Func([this]() {
-            counter++;
-            invalidate();
-        })}}, {text("Increment")}),
+            counter.set(counter.peek() + 1);
+        })}}, {HOIST(text("Increment"))}),
         button({{"onclick", Func([this]() {
-            counter = 0;
-            invalidate();
-        })}}, {text("Reset")}),
+            counter.set(0);
+        })}}, {HOIST(text("Reset"))}),
         input({
             {"type", "text"}, 
             {"placeholder", "Enter message"},
-            {"value", message.std_str()},
+            {"value", message.get().std_str()},
             {"oninput", FuncInputChange([this](const std::string& value) {
-                message = String(value.c_str());
-                invalidate();
+                message.set(String(value.c_str()));
+                // Typing must echo immediately, even mid-way through a big update
+                invalidate(Priority::URGENT);
             })}
         }),
-        h2({}, {text("Multiple Component Instances:")}),
-        MyComponent(this, 1).render(),
-        MyComponent(this, 2).render(),
-        MyComponent(this, 3).render()
+        pointer.renderCached(),
+        HOIST(h2({}, {text("Multiple Component Instances:")})),
+        card1.renderCached(),
+        card2.renderCached(),
+        card3.renderCached(),
+        HOIST(h2({}, {text("Virtual List (100,000 rows):")})),
+        rows.renderCached()
     });
   }
 };
@@ -308,6 +1129,53 @@ void startApp() {
   g_app->start();
 }
 
+#ifdef FRAMEWORK_LEAN
+// ============================================================================
+// Exports - Plain C entry points for the lean build
+// ============================================================================
+// No embind function registrations: lean-exports.js (linked with --post-js)
+// puts these on Module under the same names the embind build uses. Strings
+// and objects cross as Emval handles; val itself is still the DOM layer.
+extern "C" {
+
+EMSCRIPTEN_KEEPALIVE void fw_startApp() {
+  startApp();
+}
+
+EMSCRIPTEN_KEEPALIVE void fw_invokeEventCallback(int id) {
+  invokeEventCallback(id);
+}
+
+EMSCRIPTEN_KEEPALIVE void fw_invokeStringEventCallback(int id, EM_VAL value) {
+  invokeStringEventCallback(id, val::take_ownership(value).as<std::string>());
+}
+
+EMSCRIPTEN_KEEPALIVE void fw_onAnimationFrame() {
+  onAnimationFrame();
+}
+
+EMSCRIPTEN_KEEPALIVE void fw_onIdleCallback(double timeRemaining) {
+  onIdleCallback(timeRemaining);
+}
+
+EMSCRIPTEN_KEEPALIVE EM_VAL fw_getFrameStats(uint32_t afterFrame) {
+  return getFrameStats(afterFrame).release_ownership();
+}
+
+EMSCRIPTEN_KEEPALIVE void fw_setPerformanceMarks(int enabled) {
+  setPerformanceMarks(enabled != 0);
+}
+
+EMSCRIPTEN_KEEPALIVE void fw_connectServerView(EM_VAL url) {
+  connectServerView(val::take_ownership(url).as<std::string>());
+}
+
+EMSCRIPTEN_KEEPALIVE void fw_onServerMessages() {
+  onServerMessages();
+}
+
+}
+#else
 // ============================================================================
 // Embind - Expose to JavaScript
 // ============================================================================
@@ -315,4 +1183,11 @@ EMSCRIPTEN_BINDINGS(framework) {
   function("startApp", &startApp);
   function("invokeEventCallback", &invokeEventCallback);
   function("invokeStringEventCallback", &invokeStringEventCallback);
+  function("onAnimationFrame", &onAnimationFrame);
+  function("onIdleCallback", &onIdleCallback);
+  function("getFrameStats", &getFrameStats);
+  function("setPerformanceMarks", &setPerformanceMarks);
+  function("connectServerView", &connectServerView);
+  function("onServerMessages", &onServerMessages);
 }
+#endif
@@ -0,0 +1,19 @@
+// Linked with --post-js in the lean build (build.sh --lean). Gives the plain
+// C exports of framework.cpp the names the embind build registers, so pages
+// and EM_JS code call the same Module functions in both builds.
+Module['startApp'] = () => Module['_fw_startApp']();
+Module['invokeEventCallback'] = (id) => Module['_fw_invokeEventCallback'](id);
+Module['invokeStringEventCallback'] = (id, value) =>
+  Module['_fw_invokeStringEventCallback'](id, Emval.toHandle(String(value)));
+Module['onAnimationFrame'] = () => Module['_fw_onAnimationFrame']();
+Module['onIdleCallback'] = (timeRemaining) => Module['_fw_onIdleCallback'](timeRemaining);
+Module['getFrameStats'] = (afterFrame) => {
+  const handle = Module['_fw_getFrameStats'](afterFrame >>> 0);
+  const frames = Emval.toValue(handle);
+  __emval_decref(handle);
+  return frames;
+};
+Module['setPerformanceMarks'] = (enabled) => Module['_fw_setPerformanceMarks'](enabled ? 1 : 0);
+Module['connectServerView'] = (url) =>
+  Module['_fw_connectServerView'](Emval.toHandle(String(url)));
+Module['onServerMessages'] = () => Module['_fw_onServerMessages']();
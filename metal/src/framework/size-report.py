@@ -0,0 +1,188 @@
+#!/usr/bin/env python3
+"""Size report for a .wasm module, with an optional budget check.
+
+Usage: size-report.py MODULE.wasm [--symbols FILE] [--budget FILE]
+                      [--record-budget] [--top N]
+
+Prints the total and gzipped size, the size of each section and the largest
+function bodies. Function names come from the symbol map written by
+`emcc --emit-symbol-map` ("index:name" per line), so the shipped module
+needs no name section. With --budget, exits with status 1 when the module
+is larger than the byte count in that file, or when the file holds no
+valid byte count. With --record-budget as well, the budget is instead set to
+the measured size plus HEADROOM and written back to the file.
+"""
+
+import argparse
+import gzip
+import re
+import sys
+
+SECTION_NAMES = {
+    0: "custom", 1: "type", 2: "import", 3: "function", 4: "table",
+    5: "memory", 6: "global", 7: "export", 8: "start", 9: "element",
+    10: "code", 11: "data", 12: "datacount", 13: "tag",
+}
+
+# Room left above a recorded budget: 5%, rounded up to a whole KiB
+HEADROOM = 0.05
+
+
+class Reader:
+    def __init__(self, data, pos=0):
+        self.data = data
+        self.pos = pos
+
+    def byte(self):
+        value = self.data[self.pos]
+        self.pos += 1
+        return value
+
+    def leb(self):
+        result = shift = 0
+        while True:
+            value = self.byte()
+            result |= (value & 0x7F) << shift
+            shift += 7
+            if not value & 0x80:
+                return result
+
+    def name(self):
+        size = self.leb()
+        value = self.data[self.pos:self.pos + size].decode("utf-8", "replace")
+        self.pos += size
+        return value
+
+    def limits(self):
+        flags = self.byte()
+        self.leb()
+        if flags & 1:
+            self.leb()
+
+
+def imported_function_count(reader, end):
+    count = 0
+    for _ in range(reader.leb()):
+        reader.name()
+        reader.name()
+        kind = reader.byte()
+        if kind == 0:        # function: type index
+            reader.leb()
+            count += 1
+        elif kind == 1:      # table: reference type, limits
+            reader.byte()
+            reader.limits()
+        elif kind == 2:      # memory: limits
+            reader.limits()
+        elif kind == 3:      # global: value type, mutability
+            reader.byte()
+            reader.byte()
+        elif kind == 4:      # tag: attribute, type index
+            reader.byte()
+            reader.leb()
+    assert reader.pos == end, "malformed import section"
+    return count
+
+
+def parse(data):
+    if data[:4] != b"\0asm":
+        sys.exit("not a wasm module")
+    reader = Reader(data, 8)
+    sections = []
+    bodies = []
+    imports = 0
+    while reader.pos < len(data):
+        section_id = reader.byte()
+        size = reader.leb()
+        start = reader.pos
+        label = SECTION_NAMES.get(section_id, str(section_id))
+        if section_id == 0:
+            label = "custom:" + Reader(data, start).name()
+        elif section_id == 2:
+            imports = imported_function_count(Reader(data, start), start + size)
+        elif section_id == 10:
+            code = Reader(data, start)
+            for index in range(code.leb()):
+                body_size = code.leb()
+                bodies.append((imports + index, body_size))
+                code.pos += body_size
+        sections.append((label, size))
+        reader.pos = start + size
+    return sections, bodies
+
+
+def read_symbols(path):
+    symbols = {}
+    if path:
+        with open(path) as file:
+            for line in file:
+                index, _, name = line.rstrip("\n").partition(":")
+                if index.isdigit():
+                    symbols[int(index)] = name
+    return symbols
+
+
+def read_budget(path):
+    with open(path) as file:
+        for line in file:
+            line = line.split("#", 1)[0].strip()
+            if line:
+                if not line.isdigit():
+                    sys.exit("bad budget in %s: %r" % (path, line))
+                return int(line)
+    sys.exit("no budget in %s (record one with ./build.sh --lean --record-budget)" % path)
+
+
+def record_budget(path, size):
+    budget = -(-int(size * (1 + HEADROOM)) // 1024) * 1024
+    with open(path) as file:
+        lines = [line for line in file if not re.match(r"\s*\d", line)]
+    lines.append("%d\n" % budget)
+    with open(path, "w") as file:
+        file.writelines(lines)
+    return budget
+
+
+def main():
+    parser = argparse.ArgumentParser(description="wasm size report")
+    parser.add_argument("module")
+    parser.add_argument("--symbols")
+    parser.add_argument("--budget")
+    parser.add_argument("--record-budget", action="store_true")
+    parser.add_argument("--top", type=int, default=25)
+    args = parser.parse_args()
+
+    with open(args.module, "rb") as file:
+        data = file.read()
+    sections, bodies = parse(data)
+    symbols = read_symbols(args.symbols)
+    code_size = sum(size for _, size in bodies) or 1
+
+    print("%s: %d bytes (%d gzipped)" % (args.module, len(data), len(gzip.compress(data, 9))))
+    print()
+    print("Sections:")
+    for label, size in sorted(sections, key=lambda s: -s[1]):
+        print("  %-28s %9d  %5.1f%%" % (label, size, 100.0 * size / len(data)))
+    print()
+    print("Largest functions (%d bodies, %d bytes of code):" % (len(bodies), code_size))
+    for index, size in sorted(bodies, key=lambda b: -b[1])[:args.top]:
+        name = symbols.get(index, "func[%d]" % index)
+        print("  %9d  %5.1f%%  %s" % (size, 100.0 * size / code_size, name))
+
+    if args.budget:
+        print()
+        if args.record_budget:
+            budget = record_budget(args.budget, len(data))
+            print("Recorded budget: %d bytes (measured %d + %d%% headroom) in %s"
+                  % (budget, len(data), HEADROOM * 100, args.budget))
+            return 0
+        budget = read_budget(args.budget)
+        if len(data) > budget:
+            print("Over budget: %d bytes > %d (%s)" % (len(data), budget, args.budget))
+            return 1
+        print("Within budget: %d of %d bytes" % (len(data), budget))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,92 @@
+// ============================================================================
+// WasmLoader - Streaming instantiation with a content-addressed module cache
+// ============================================================================
+// Plugs into a MODULARIZE'd Emscripten build through its instantiateWasm hook:
+//
+//   Module(Object.assign(ModuleOptions, WasmLoader.options('framework.wasm', '<hash>')))
+//
+// The module is compiled with WebAssembly.instantiateStreaming while its bytes
+// arrive, which needs the server to send Content-Type: application/wasm.
+//
+// Responses are kept in Cache Storage under "<url>?v=<hash>", where the hash
+// is the one build.sh computes from the .wasm file. Browsers no longer allow
+// storing a WebAssembly.Module in IndexedDB, but they do attach compiled code
+// to a cached response that was stream-compiled: a repeat visit streams from
+// the cache and reuses that code instead of compiling again. A new build has
+// a new hash, so stale modules are never served; the old entry is dropped.
+const WasmLoader = (() => {
+  const CACHE_NAME = 'wasm-modules';
+
+  function versionedUrl(url, hash) {
+    return hash ? url + '?v=' + hash : url;
+  }
+
+  // Remove cached builds of `url` other than the current one
+  async function pruneCache(cache, url, keep) {
+    const path = new URL(url, location.href).pathname;
+    for (const request of await cache.keys()) {
+      if (new URL(request.url).pathname === path && request.url !== keep) {
+        await cache.delete(request);
+      }
+    }
+  }
+
+  // The module's response, from Cache Storage when possible. Cache writes
+  // happen in the background so they never hold up compilation.
+  async function fetchModule(url, hash) {
+    const key = versionedUrl(url, hash);
+    if (!hash || typeof caches === 'undefined') {
+      return fetch(key);
+    }
+
+    try {
+      const cache = await caches.open(CACHE_NAME);
+      const cached = await cache.match(key);
+      if (cached) {
+        return cached;
+      }
+
+      const response = await fetch(key);
+      if (response.ok) {
+        cache.put(key, response.clone())
+          .then(() => pruneCache(cache, url, new URL(key, location.href).href))
+          .catch((error) => console.warn('WasmLoader: not cached:', error));
+      }
+      return response;
+    } catch (error) {
+      // Cache Storage is unavailable (private mode, insecure origin)
+      return fetch(key);
+    }
+  }
+
+  async function instantiate(url, hash, imports) {
+    if (WebAssembly.instantiateStreaming) {
+      try {
+        return await WebAssembly.instantiateStreaming(fetchModule(url, hash), imports);
+      } catch (error) {
+        // Usually a wrong Content-Type; the buffered path below still works
+        console.warn('WasmLoader: streaming compile failed, falling back:', error);
+      }
+    }
+
+    const response = await fetch(versionedUrl(url, hash));
+    if (!response.ok) {
+      throw new Error('WasmLoader: ' + url + ': HTTP ' + response.status);
+    }
+    return WebAssembly.instantiate(await response.arrayBuffer(), imports);
+  }
+
+  // Module options that route instantiation through this loader
+  function options(url, hash) {
+    return {
+      instantiateWasm(imports, receiveInstance) {
+        instantiate(url, hash, imports)
+          .then((result) => receiveInstance(result.instance, result.module))
+          .catch((error) => console.error('WasmLoader: failed to load ' + url + ':', error));
+        return {};  // Exports arrive asynchronously through receiveInstance
+      }
+    };
+  }
+
+  return { options };
+})();
@@ -0,0 +1,155 @@
+#ifndef JsonWriter_hpp
+#define JsonWriter_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * JSON Writer - Compact JSON for fixed-shape responses
+ *
+ * For hot endpoints whose shape never changes: the constant parts are
+ * written as precomputed literals (see ApiController) and only the values
+ * are formatted, into a buffer owned by the calling thread and reused by
+ * every response it builds. No DTO, no ObjectMapper, no intermediate
+ * strings; the only allocation is the response body copied out at the end.
+ *
+ * Output is compact (no whitespace) and strings are escaped per RFC 8259.
+ * Bytes that are not valid UTF-8 become U+FFFD, so the result is always
+ * valid JSON whatever the request carried.
+ */
+class JsonWriter {
+private:
+  std::string& m_out;
+
+public:
+
+  /**
+   * Start a document in the calling thread's buffer
+   */
+  JsonWriter() : m_out(threadBuffer()) {
+    m_out.clear();
+  }
+
+  /**
+   * Append JSON text as-is (a precomputed constant part)
+   */
+  JsonWriter& raw(std::string_view json) {
+    m_out.append(json.data(), json.size());
+    return *this;
+  }
+
+  /**
+   * Append the escaped contents of a string, without the quotes
+   */
+  JsonWriter& escaped(std::string_view s) {
+    static const char hex[] = "0123456789abcdef";
+    size_t i = 0;
+    while (i < s.size()) {
+      unsigned char c = static_cast<unsigned char>(s[i]);
+      if (c >= 0x80) {
+        size_t length = utf8SequenceLength(s, i);
+        if (length) {
+          m_out.append(s.data() + i, length);
+          i += length;
+        } else {
+          m_out.append("\\ufffd");
+          ++i;
+        }
+        continue;
+      }
+      switch (c) {
+        case '"': m_out.append("\\\""); break;
+        case '\\': m_out.append("\\\\"); break;
+        case '\n': m_out.append("\\n"); break;
+        case '\r': m_out.append("\\r"); break;
+        case '\t': m_out.append("\\t"); break;
+        case '\b': m_out.append("\\b"); break;
+        case '\f': m_out.append("\\f"); break;
+        default:
+          if (c < 0x20) {
+            const char escape[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+            m_out.append(escape, sizeof(escape));
+          } else {
+            m_out.push_back(static_cast<char>(c));
+          }
+      }
+      ++i;
+    }
+    return *this;
+  }
+
+  /**
+   * Append an integer's decimal digits
+   */
+  JsonWriter& integer(int64_t value) {
+    char digits[20];
+    size_t count = 0;
+    uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    do {
+      digits[count++] = static_cast<char>('0' + magnitude % 10);
+      magnitude /= 10;
+    } while (magnitude);
+    if (value < 0) {
+      m_out.push_back('-');
+    }
+    while (count) {
+      m_out.push_back(digits[--count]);
+    }
+    return *this;
+  }
+
+  const char* data() const {
+    return m_out.data();
+  }
+
+  size_t size() const {
+    return m_out.size();
+  }
+
+private:
+
+  // Kept for the thread's lifetime; it stops growing at the largest response
+  static std::string& threadBuffer() {
+    thread_local std::string buffer = [] {
+      std::string initial;
+      initial.reserve(256);
+      return initial;
+    }();
+    return buffer;
+  }
+
+  // Length of the well-formed UTF-8 sequence starting at s[i], or 0
+  static size_t utf8SequenceLength(std::string_view s, size_t i) {
+    unsigned char lead = static_cast<unsigned char>(s[i]);
+    size_t length;
+    unsigned char low = 0x80, high = 0xBF;  // Range of the second byte
+    if (lead >= 0xC2 && lead <= 0xDF) {
+      length = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+      length = 3;
+      if (lead == 0xE0) low = 0xA0;         // Overlong
+      else if (lead == 0xED) high = 0x9F;   // UTF-16 surrogates
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+      length = 4;
+      if (lead == 0xF0) low = 0x90;         // Overlong
+      else if (lead == 0xF4) high = 0x8F;   // Above U+10FFFF
+    } else {
+      return 0;
+    }
+    if (s.size() - i < length) {
+      return 0;
+    }
+    for (size_t k = 1; k < length; ++k) {
+      unsigned char c = static_cast<unsigned char>(s[i + k]);
+      if (k == 1 ? (c < low || c > high) : (c < 0x80 || c > 0xBF)) {
+        return 0;
+      }
+    }
+    return length;
+  }
+
+};
+
+#endif /* JsonWriter_hpp */
@@ -1,11 +1,13 @@
 #include "./AppComponent.hpp"
 #include "./controller/ApiController.hpp"
 #include "./controller/StaticController.hpp"
+#ifdef METAL_SERVER_UI
+#include "./controller/UiController.hpp"
+#endif
 
 #include "oatpp/network/Server.hpp"
 
 #include <iostream>
-#include <filesystem>
 
 void run() {
   
@@ -15,15 +17,31 @@ void run() {
   // Get Router component
   OATPP_COMPONENT(std::shared_ptr<oatpp::web::server::HttpRouter>, router);
   
-  // Determine static files path
+  // Determine static files: STATIC_PATH if set, otherwise the files compiled
+  // into the binary (METAL_EMBED_ASSETS), otherwise ./static
   std::string staticPath = "./static";
   const char* staticEnv = std::getenv("STATIC_PATH");
   if (staticEnv) {
     staticPath = staticEnv;
   }
   
-  // Check if static files exist
-  bool hasStaticFiles = std::filesystem::exists(staticPath + "/index.html");
+  std::shared_ptr<AssetIndex> assets;
+#ifdef METAL_EMBED_ASSETS
+  if (!staticEnv) {
+    assets = AssetIndex::embedded();
+    staticPath = "(embedded in binary)";
+  }
+#endif
+  if (!assets) {
+    // Index the static tree once; requests are then served from memory
+    assets = AssetIndex::scan(staticPath);
+  }
+  bool hasStaticFiles = assets->find("index.html") != nullptr;
+  
+#ifdef METAL_SERVER_UI
+  // Server-driven view socket; ahead of the static catch-all like the API
+  router->addController(std::make_shared<UiController>());
+#endif
   
   if (hasStaticFiles) {
     // Create and add ApiController first (so /health and /api/* take priority)
@@ -31,7 +49,7 @@ void run() {
     router->addController(apiController);
     
     // Create and add StaticController last (catches remaining routes)
-    auto staticController = std::make_shared<StaticController>(staticPath);
+    auto staticController = std::make_shared<StaticController>(assets);
     router->addController(staticController);
   } else {
     // No static files - just serve API
@@ -60,10 +78,15 @@ void run() {
   std::cout << "│  Endpoints:                         │\n";
   if (hasStaticFiles) {
     std::cout << "│    GET  /           (Client App)    │\n";
-    std::cout << "│    GET  /{file}     (Static Files)  │\n";
+    std::cout << "│    GET  /*          (Static Files)  │\n";
   }
   std::cout << "│    GET  /health                     │\n";
   std::cout << "│    GET  /api/hello?name=<name>      │\n";
+  std::cout << "│    POST /api/rpc    (Batched RPC)   │\n";
+  std::cout << "│    GET  /api/cache/stats            │\n";
+#ifdef METAL_SERVER_UI
+  std::cout << "│    WS   /ui         (Server View)   │\n";
+#endif
   std::cout << "└─────────────────────────────────────┘\n";
   
   if (!hasStaticFiles) {
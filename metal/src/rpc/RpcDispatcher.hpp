@@ -0,0 +1,81 @@
+#ifndef RpcDispatcher_hpp
+#define RpcDispatcher_hpp
+
+#include "rpc/RpcProtocol.hpp"
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * RPC Dispatcher - Runs every call of a batch against a method table
+ *
+ * Handlers read their arguments from an RpcReader over just their own
+ * bytes and write the result straight into the response; nothing is
+ * parsed or copied in between.
+ */
+class RpcDispatcher {
+public:
+  using Handler = std::function<RpcStatus(RpcReader& args, RpcWriter& result)>;
+
+private:
+  std::vector<Handler> m_handlers;  // Indexed by method ID
+
+public:
+
+  /**
+   * Register (or replace) the handler for `method`
+   */
+  void add(RpcMethod method, Handler handler) {
+    size_t index = static_cast<size_t>(method);
+    if (m_handlers.size() <= index) {
+      m_handlers.resize(index + 1);
+    }
+    m_handlers[index] = std::move(handler);
+  }
+
+  /**
+   * Run a request batch into `response`. Returns false when the batch itself
+   * is malformed (truncated, trailing bytes, too many calls); a bad call
+   * inside a well-formed batch only fails that call.
+   */
+  bool dispatch(std::string_view request, std::string& response) const {
+    RpcReader in(request);
+    uint16_t count = in.readU16();
+    if (in.failed() || count > kRpcMaxBatch) {
+      return false;
+    }
+
+    response.clear();
+    RpcWriter out(response);
+    out.writeU16(count);
+    for (uint16_t i = 0; i < count; ++i) {
+      uint16_t method = in.readU16();
+      RpcReader args(in.readBlock());
+      if (in.failed()) {
+        return false;
+      }
+
+      size_t statusOffset = out.size();
+      out.writeU8(static_cast<uint8_t>(RpcStatus::OK));
+      size_t block = out.beginBlock();
+      RpcStatus status = RpcStatus::UNKNOWN_METHOD;
+      if (method < m_handlers.size() && m_handlers[method]) {
+        status = m_handlers[method](args, out);
+        if (status == RpcStatus::OK && (args.failed() || !args.atEnd())) {
+          status = RpcStatus::BAD_ARGUMENTS;
+        }
+      }
+      if (status != RpcStatus::OK) {
+        out.truncate(block + 4);  // Failed calls have an empty result
+        out.patchU8(statusOffset, static_cast<uint8_t>(status));
+      }
+      out.endBlock(block);
+    }
+    return in.atEnd();
+  }
+
+};
+
+#endif /* RpcDispatcher_hpp */
@@ -0,0 +1,204 @@
+#ifndef RpcProtocol_hpp
+#define RpcProtocol_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * Batched binary RPC between MetalClient and the server (POST /api/rpc)
+ *
+ * One request body carries every call the client queued during a frame, and
+ * one response carries every result, in call order. Little-endian:
+ *
+ *   request  := u16 count, count * (u16 method, u32 size, args[size])
+ *   response := u16 count, count * (u8 status, u32 size, result[size])
+ *
+ * Arguments and results are written with RpcWriter and read with RpcReader:
+ * fixed-width integers, and strings as u32 length + bytes. A failed call has
+ * an empty result; the rest of the batch is unaffected.
+ *
+ * Shared by the server (rpc/RpcDispatcher.hpp) and the wasm client
+ * (client/client.cpp), so it depends on nothing but the standard library.
+ */
+
+enum class RpcMethod : uint16_t {
+  HELLO = 1,        // (string name) -> string message
+  SERVER_TIME = 2   // () -> i64 unix seconds
+};
+
+enum class RpcStatus : uint8_t {
+  OK = 0,
+  UNKNOWN_METHOD = 1,
+  BAD_ARGUMENTS = 2
+};
+
+// Calls per batch; a client with more queued sends them in several batches
+constexpr size_t kRpcMaxBatch = 256;
+
+inline const char* rpcStatusMessage(RpcStatus status) {
+  switch (status) {
+    case RpcStatus::OK: return "ok";
+    case RpcStatus::UNKNOWN_METHOD: return "unknown method";
+    case RpcStatus::BAD_ARGUMENTS: return "bad arguments";
+  }
+  return "unknown status";
+}
+
+/**
+ * Appends little-endian values to a byte string
+ */
+class RpcWriter {
+private:
+  std::string& m_out;
+
+public:
+
+  explicit RpcWriter(std::string& out) : m_out(out) {}
+
+  void writeU8(uint8_t v) {
+    m_out.push_back(static_cast<char>(v));
+  }
+
+  void writeU16(uint16_t v) {
+    writeLittleEndian(v, 2);
+  }
+
+  void writeU32(uint32_t v) {
+    writeLittleEndian(v, 4);
+  }
+
+  void writeI64(int64_t v) {
+    writeLittleEndian(static_cast<uint64_t>(v), 8);
+  }
+
+  void writeString(std::string_view s) {
+    writeU32(static_cast<uint32_t>(s.size()));
+    m_out.append(s.data(), s.size());
+  }
+
+  /**
+   * Start a u32 size-prefixed block; pass the result to endBlock()
+   */
+  size_t beginBlock() {
+    size_t mark = m_out.size();
+    writeU32(0);
+    return mark;
+  }
+
+  void endBlock(size_t mark) {
+    uint64_t size = m_out.size() - mark - 4;
+    for (size_t i = 0; i < 4; ++i) {
+      m_out[mark + i] = static_cast<char>((size >> (8 * i)) & 0xFF);
+    }
+  }
+
+  /**
+   * Overwrite a byte written earlier (e.g. a status decided afterwards)
+   */
+  void patchU8(size_t offset, uint8_t v) {
+    m_out[offset] = static_cast<char>(v);
+  }
+
+  /**
+   * Drop everything after `size` bytes
+   */
+  void truncate(size_t size) {
+    m_out.resize(size);
+  }
+
+  size_t size() const {
+    return m_out.size();
+  }
+
+private:
+
+  void writeLittleEndian(uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+      m_out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+    }
+  }
+
+};
+
+/**
+ * Reads what RpcWriter wrote. Reading past the end sets failed() and yields
+ * zeros and empty strings instead.
+ */
+class RpcReader {
+private:
+  std::string_view m_data;
+  size_t m_pos = 0;
+  bool m_failed = false;
+
+public:
+
+  explicit RpcReader(std::string_view data) : m_data(data) {}
+
+  bool failed() const {
+    return m_failed;
+  }
+
+  bool atEnd() const {
+    return m_pos == m_data.size();
+  }
+
+  uint8_t readU8() {
+    return static_cast<uint8_t>(readLittleEndian(1));
+  }
+
+  uint16_t readU16() {
+    return static_cast<uint16_t>(readLittleEndian(2));
+  }
+
+  uint32_t readU32() {
+    return static_cast<uint32_t>(readLittleEndian(4));
+  }
+
+  int64_t readI64() {
+    return static_cast<int64_t>(readLittleEndian(8));
+  }
+
+  std::string readString() {
+    return std::string(readBlock());
+  }
+
+  /**
+   * A u32 size-prefixed block, as a view into the input
+   */
+  std::string_view readBlock() {
+    uint32_t size = readU32();
+    if (!take(size)) {
+      return std::string_view();
+    }
+    std::string_view block = m_data.substr(m_pos, size);
+    m_pos += size;
+    return block;
+  }
+
+private:
+
+  bool take(size_t count) {
+    if (m_failed || m_data.size() - m_pos < count) {
+      m_failed = true;
+      return false;
+    }
+    return true;
+  }
+
+  uint64_t readLittleEndian(int bytes) {
+    if (!take(static_cast<size_t>(bytes))) {
+      return 0;
+    }
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i) {
+      v |= static_cast<uint64_t>(static_cast<uint8_t>(m_data[m_pos + i])) << (8 * i);
+    }
+    m_pos += static_cast<size_t>(bytes);
+    return v;
+  }
+
+};
+
+#endif /* RpcProtocol_hpp */
@@ -0,0 +1,38 @@
+#ifndef CounterSession_hpp
+#define CounterSession_hpp
+
+#include "ui/UiSession.hpp"
+
+#include <string>
+
+/**
+ * Counter Session - The server-driven view served at /ui
+ *
+ * A counter and a greeting: every click and keystroke round-trips to the
+ * server, which answers with only the text nodes that changed.
+ */
+class CounterSession : public UiSession {
+private:
+  int m_count = 0;
+  std::string m_name;
+
+protected:
+
+  VNode render() override {
+    return div({{"style", "font-family: sans-serif; padding: 20px;"}}, {
+      h1({}, {text("Server-driven view")}),
+      p({}, {text("Count: " + std::to_string(m_count))}),
+      button({{"data-sui-click", onClick([this]() { ++m_count; })}}, {text("Increment")}),
+      button({{"data-sui-click", onClick([this]() { m_count = 0; })}}, {text("Reset")}),
+      input({
+        {"type", "text"},
+        {"placeholder", "Your name"},
+        {"data-sui-input", onInput([this](const std::string& value) { m_name = value; })}
+      }),
+      p({}, {text("Hello, " + (m_name.empty() ? std::string("stranger") : m_name) + "!")})
+    });
+  }
+
+};
+
+#endif /* CounterSession_hpp */
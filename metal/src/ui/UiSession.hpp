@@ -0,0 +1,111 @@
+#ifndef UiSession_hpp
+#define UiSession_hpp
+
+#include "framework/VNode.hpp"
+#include "framework/Diff.hpp"
+#include "framework/PatchStream.hpp"
+#include "framework/CallbackRegistry.hpp"
+#include "framework/UiEvent.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * UI Session - State of one server-driven view
+ *
+ * Subclasses hold component state and render() it to a VNode tree with the
+ * framework's helpers, as a client component would. After each client event
+ * the session renders, diffs against the tree the page already shows, and
+ * encodes only the difference as a PatchStream - the frame sent back.
+ *
+ * Between events a session keeps its state, the last tree and its handler
+ * slots; nothing is kept per frame. Render code builds strings with
+ * std::string, not fmt(): frame arena views do not outlive a render here.
+ */
+class UiSession {
+public:
+  virtual ~UiSession() = default;
+
+  /**
+   * Handle one UiEvent frame from the page. Returns true with the frame to
+   * send back in `out`; false when the event changed nothing (or was malformed).
+   */
+  bool handle(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+    UiEvent event;
+    if (!decodeUiEvent(data, size, event)) {
+      return false;
+    }
+    switch (event.kind) {
+      case UiEventKind::HELLO:
+        m_tree.reset();  // New or out-of-sync page: send the whole tree
+        break;
+      case UiEventKind::CLICK:
+        m_clicks.invoke(static_cast<int>(event.id));
+        break;
+      case UiEventKind::INPUT:
+        m_inputs.invoke(static_cast<int>(event.id), event.value);
+        break;
+    }
+    return update(out);
+  }
+
+protected:
+
+  /**
+   * Render the current state
+   */
+  virtual VNode render() = 0;
+
+  /**
+   * Value for a data-sui-click attribute
+   */
+  template <typename F>
+  std::string onClick(F&& callback) {
+    return std::to_string(m_clicks.add(std::forward<F>(callback)));
+  }
+
+  /**
+   * Value for a data-sui-input attribute; receives the element's value
+   */
+  template <typename F>
+  std::string onInput(F&& callback) {
+    return std::to_string(m_inputs.add(std::forward<F>(callback)));
+  }
+
+private:
+
+  // Handlers the new render no longer uses are freed right away, so an event
+  // aimed at something that has left the page is dropped
+  bool update(std::vector<uint8_t>& out) {
+    m_clicks.beginFrame();
+    m_inputs.beginFrame();
+    VNode tree = render();
+    m_clicks.commit();
+    m_inputs.commit();
+
+    DiffNode diff;
+    if (m_tree) {
+      diff = diffNodes(*m_tree, tree);
+    } else {
+      diff.op = DiffOp::REPLACE;
+      diff.newNode = tree;
+    }
+    m_tree = std::move(tree);
+
+    if (!diff.hasChanges()) {
+      return false;
+    }
+    out.clear();
+    encodePatchStream(diff, out);
+    return true;
+  }
+
+  std::optional<VNode> m_tree;  // What the page shows
+  CallbackRegistry<void()> m_clicks;
+  CallbackRegistry<void(const std::string&)> m_inputs;
+};
+
+#endif /* UiSession_hpp */
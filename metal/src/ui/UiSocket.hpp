@@ -0,0 +1,112 @@
+#ifndef UiSocket_hpp
+#define UiSocket_hpp
+
+#include "ui/UiSession.hpp"
+
+#include "oatpp-websocket/AsyncConnectionHandler.hpp"
+#include "oatpp-websocket/AsyncWebSocket.hpp"
+#include "oatpp-websocket/Frame.hpp"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * UI Socket Listener - Connects one WebSocket to one UiSession
+ *
+ * Frames of a socket are handled one at a time by its coroutine, so the
+ * session needs no locking. The server only ever answers an event; it never
+ * sends unprompted, so there is no outgoing queue to keep per session.
+ */
+class UiSocketListener : public oatpp::websocket::AsyncWebSocket::Listener {
+private:
+  // UiEvent frames are a few bytes; anything this large is not one of ours
+  static constexpr size_t kMaxMessageSize = 64 * 1024;
+
+  std::unique_ptr<UiSession> m_session;
+  std::string m_message;      // Fragments of the message being received
+  bool m_oversized = false;
+
+public:
+
+  explicit UiSocketListener(std::unique_ptr<UiSession> session)
+    : m_session(std::move(session))
+  {}
+
+  CoroutineStarter onPing(const std::shared_ptr<AsyncWebSocket>& socket, const oatpp::String& message) override {
+    return socket->sendPongAsync(message);
+  }
+
+  CoroutineStarter onPong(const std::shared_ptr<AsyncWebSocket>& /* socket */, const oatpp::String& /* message */) override {
+    return nullptr;
+  }
+
+  CoroutineStarter onClose(const std::shared_ptr<AsyncWebSocket>& /* socket */, v_uint16 /* code */,
+                           const oatpp::String& /* message */) override {
+    return nullptr;
+  }
+
+  CoroutineStarter readMessage(const std::shared_ptr<AsyncWebSocket>& socket, v_uint8 opcode, p_char8 data, oatpp::v_io_size size) override {
+    if (size > 0) {
+      // More of the current frame
+      if (m_message.size() + static_cast<size_t>(size) > kMaxMessageSize) {
+        m_oversized = true;
+      } else if (!m_oversized) {
+        m_message.append(reinterpret_cast<const char*>(data), static_cast<size_t>(size));
+      }
+      return nullptr;
+    }
+
+    // size == 0: the message is complete
+    std::string message;
+    message.swap(m_message);
+    bool dropped = m_oversized || opcode == oatpp::websocket::Frame::OPCODE_TEXT;
+    m_oversized = false;
+    if (dropped) {
+      return nullptr;
+    }
+
+    std::vector<uint8_t> patch;
+    if (!m_session->handle(reinterpret_cast<const uint8_t*>(message.data()), message.size(), patch)) {
+      return nullptr;
+    }
+    return socket->sendOneFrameBinaryAsync(
+        oatpp::String(std::string(reinterpret_cast<const char*>(patch.data()), patch.size())));
+  }
+
+};
+
+/**
+ * UI Socket Instance Listener - Starts a fresh session for every socket
+ */
+class UiSocketInstanceListener : public oatpp::websocket::AsyncConnectionHandler::SocketInstanceListener {
+public:
+  using SessionFactory = std::function<std::unique_ptr<UiSession>()>;
+
+private:
+  SessionFactory m_factory;
+  std::atomic<v_int32> m_sockets{0};
+
+public:
+
+  explicit UiSocketInstanceListener(SessionFactory factory)
+    : m_factory(std::move(factory))
+  {}
+
+  void onAfterCreate_NonBlocking(const std::shared_ptr<oatpp::websocket::AsyncWebSocket>& socket,
+                                 const std::shared_ptr<const ParameterMap>& /* params */) override {
+    v_int32 sockets = ++m_sockets;
+    OATPP_LOGD("UiSocket", "Session opened (%d open)", sockets);
+    socket->setListener(std::make_shared<UiSocketListener>(m_factory()));
+  }
+
+  void onBeforeDestroy_NonBlocking(const std::shared_ptr<oatpp::websocket::AsyncWebSocket>& /* socket */) override {
+    v_int32 sockets = --m_sockets;
+    OATPP_LOGD("UiSocket", "Session closed (%d open)", sockets);
+  }
+
+};
+
+#endif /* UiSocket_hpp */